@@ -10,14 +10,25 @@ if not exist "%OUT%" mkdir "%OUT%"
 emcc ^
  "%SRC%\linkedlist.cpp" ^
  "%SRC%\heap.cpp" ^
+ "%SRC%\heapstream.cpp" ^
+ "%SRC%\multiqueue.cpp" ^
  "%SRC%\avl.cpp" ^
  "%SRC%\graph.cpp" ^
+ "%SRC%\graphbfs.cpp" ^
+ "%SRC%\graphloader.cpp" ^
+ "%SRC%\graphsssp.cpp" ^
+ "%SRC%\graphmst.cpp" ^
+ "%SRC%\graphspt.cpp" ^
+ "%SRC%\graphp2p.cpp" ^
+ "%SRC%\graphorder.cpp" ^
+ "%SRC%\disjointset.cpp" ^
+ "%SRC%\threadpool.cpp" ^
  "%SRC%\hash.cpp" ^
  "%BINDINGS%\bindings.cpp" ^
  -o "%OUT%\ds.js" ^
  -s WASM=1 -O3 ^
  -s EXPORTED_RUNTIME_METHODS=[\"cwrap\",\"ccall\"] ^
- -s EXPORTED_FUNCTIONS=[\"_ll_create\",\"_ll_push_front\",\"_ll_push_back\",\"_ll_pop_front\",\"_ll_pop_back\",\"_ll_get_head\",\"_ll_get_tail\",\"_ll_destroy\",\"_avl_create\",\"_avl_insert\",\"_avl_delete\",\"_avl_get_height\",\"_avl_destroy\",\"_heap_create\",\"_heap_insert_min\",\"_heap_insert_max\",\"_heap_delete_root\",\"_heap_destroy\",\"_graph_create\",\"_graph_add_node\",\"_graph_remove_node\",\"_graph_add_edge\",\"_graph_add_undirected_edge\",\"_graph_remove_edge\",\"_graph_get_vertex_count\",\"_graph_bfs\",\"_graph_dfs\",\"_graph_dijkstra\",\"_graph_prim\",\"_graph_print\",\"_graph_destroy\",\"_hash_create\",\"_hash_insert\",\"_hash_search\",\"_hash_remove\",\"_hash_destroy\"]
+ -s EXPORTED_FUNCTIONS=[\"_ll_create\",\"_ll_push_front\",\"_ll_push_back\",\"_ll_pop_front\",\"_ll_pop_back\",\"_ll_get_head\",\"_ll_get_tail\",\"_ll_destroy\",\"_avl_create\",\"_avl_insert\",\"_avl_delete\",\"_avl_bulk_load\",\"_avl_size\",\"_avl_rank\",\"_avl_select\",\"_avl_count_range\",\"_avl_range\",\"_avl_set_operation\",\"_avl_compile\",\"_avl_compiled_contains\",\"_avl_compiled_lower_bound\",\"_avl_compiled_contains_batch\",\"_avl_compiled_destroy\",\"_avl_set_persistent\",\"_avl_snapshot\",\"_avl_checkout\",\"_avl_release_version\",\"_avl_get_height\",\"_avl_destroy\",\"_heap_create\",\"_heap_insert_min\",\"_heap_insert_max\",\"_heap_delete_root\",\"_heap_build\",\"_heap_insert_batch\",\"_heap_extract_k\",\"_heap_get_element\",\"_heap_get_size\",\"_heap_replace_top\",\"_heap_push_pop\",\"_heap_destroy\",\"_topk_create\",\"_topk_push_batch\",\"_topk_extract\",\"_topk_destroy\",\"_heap_merge_runs\",\"_multiqueue_create\",\"_multiqueue_push\",\"_multiqueue_push_batch\",\"_multiqueue_pop\",\"_multiqueue_size\",\"_multiqueue_destroy\",\"_graph_create\",\"_graph_load_text\",\"_graph_load_binary\",\"_graph_add_node\",\"_graph_remove_node\",\"_graph_add_edge\",\"_graph_add_undirected_edge\",\"_graph_remove_edge\",\"_graph_get_vertex_count\",\"_graph_set_stable_ids\",\"_graph_is_alive\",\"_graph_get_live_count\",\"_graph_bfs\",\"_graph_bfs_parallel\",\"_graph_dfs\",\"_graph_dijkstra\",\"_graph_delta_stepping\",\"_graph_track_source\",\"_graph_untrack_source\",\"_graph_cached_dist\",\"_graph_cached_parent\",\"_graph_reorder\",\"_graph_set_coords\",\"_graph_shortest_path\",\"_graph_prim\",\"_graph_boruvka\",\"_graph_kruskal\",\"_graph_clear_edges\",\"_graph_alloc_stats\",\"_graph_freeze\",\"_graph_unfreeze\",\"_graph_print\",\"_graph_destroy\",\"_hash_create\",\"_hash_insert\",\"_hash_search\",\"_hash_remove\",\"_hash_destroy\"]
 
 
 if %ERRORLEVEL% neq 0 (
@@ -1,7 +1,10 @@
 #include "./ds/linkedlist.h"
 #include "./ds/AVL.h"
 #include "./ds/heap.h"
+#include "./ds/heapstream.h"
+#include "./ds/multiqueue.h"
 #include "./ds/graph.h"
+#include "./ds/graphloader.h"
 #include "ds/hash.h"
 
 extern "C" {
@@ -60,30 +63,112 @@ void ll_destroy(void* ptr) {
 // ============================ AVL ==============================
 // ===============================================================
 
+typedef AVLTree<int> intavl;
+typedef AVLcompiled<int> intavlcompiled;
+
 // Create AVL tree
 void* avl_create() {
-    return new AVLTree();
+    return new intavl();
 }
 
 // Insert key
 void avl_insert(void* ptr, int key) {
-    ((AVLTree*)ptr)->insertKey(key);
+    ((intavl*)ptr)->insertKey(key);
 }
 
 // Delete key
 void avl_delete(void* ptr, int key) {
-    ((AVLTree*)ptr)->deleteKey(key);
+    ((intavl*)ptr)->deleteKey(key);
+}
+
+// Replace contents with n keys; ascending input builds in O(n)
+void avl_bulk_load(void* ptr, int* keys, int n) {
+    ((intavl*)ptr)->bulkLoad(keys, n);
+}
+
+// Number of keys
+int avl_size(void* ptr) {
+    return ((intavl*)ptr)->size();
+}
+
+// Number of keys less than key
+int avl_rank(void* ptr, int key) {
+    return ((intavl*)ptr)->rank(key);
+}
+
+// k-th smallest key (0-based); k must be below avl_size
+int avl_select(void* ptr, int k) {
+    int key = 0;
+    ((intavl*)ptr)->select(k, key);
+    return key;
+}
+
+// Number of keys in [lo, hi]
+int avl_count_range(void* ptr, int lo, int hi) {
+    return ((intavl*)ptr)->countRange(lo, hi);
+}
+
+// Write up to cap keys in [lo, hi] ascending; returns how many
+int avl_range(void* ptr, int lo, int hi, int* out, int cap) {
+    return ((intavl*)ptr)->rangeScan(lo, hi, out, cap);
+}
+
+// a = a op b (0 = union, 1 = intersection, 2 = difference); b is unchanged
+void avl_set_operation(void* a, void* b, int op) {
+    ((intavl*)a)->setoperation(op, *(intavl*)b);
+}
+
+// Read-only snapshot for lookups; free with avl_compiled_destroy
+void* avl_compile(void* ptr) {
+    return ((intavl*)ptr)->compile();
+}
+
+int avl_compiled_contains(void* c, int key) {
+    return ((intavlcompiled*)c)->contains(key);
+}
+
+// Smallest key >= key in *out; returns 0 if there is none
+int avl_compiled_lower_bound(void* c, int key, int* out) {
+    return ((intavlcompiled*)c)->lowerBound(key, *out);
+}
+
+// out[i] = 1 if q[i] is present; returns how many were
+int avl_compiled_contains_batch(void* c, int* q, int m, int* out) {
+    return ((intavlcompiled*)c)->containsBatch(q, m, out);
+}
+
+void avl_compiled_destroy(void* c) {
+    delete (intavlcompiled*)c;
+}
+
+// Keep earlier versions alive across updates (0 releases them all)
+void avl_set_persistent(void* ptr, int on) {
+    ((intavl*)ptr)->setPersistent(on != 0);
+}
+
+// Handle on the current version; enables persistent mode
+int avl_snapshot(void* ptr) {
+    return ((intavl*)ptr)->snapshot();
+}
+
+// Make version v current
+void avl_checkout(void* ptr, int v) {
+    ((intavl*)ptr)->checkout(v);
+}
+
+void avl_release_version(void* ptr, int v) {
+    ((intavl*)ptr)->releaseVersion(v);
 }
 
 // Get height of root
 int avl_get_height(void* ptr) {
-    AVLTree* tree = (AVLTree*)ptr;
+    intavl* tree = (intavl*)ptr;
     return tree->height(tree->getRoot());
 }
 
 // destroy AVL tree
 void avl_destroy(void* ptr) {
-    delete (AVLTree*)ptr;
+    delete (intavl*)ptr;
 }
 // ===============================================================
 // ============================ HEAP ==============================
@@ -105,10 +190,104 @@ void heap_delete_root(void* ptr) {
     ((heap*)ptr)->deleteelement();
 }
 
+// Replace contents with buf[0..n) and heapify in O(n); mode 0 = min, 1 = max
+void heap_build(void* ptr, int* buf, int n, int mode) {
+    ((heap*)ptr)->buildFrom(buf, n, mode);
+}
+
+void heap_insert_batch(void* ptr, int* buf, int n) {
+    ((heap*)ptr)->insertBatch(buf, n);
+}
+
+// Pop up to k roots into out; returns how many
+int heap_extract_k(void* ptr, int k, int* out) {
+    return ((heap*)ptr)->extractK(k, out);
+}
+
+// 1-based; -1 when out of range
+int heap_get_element(void* ptr, int index) {
+    return ((heap*)ptr)->getElement(index);
+}
+
+int heap_get_size(void* ptr) {
+    return ((heap*)ptr)->getSize();
+}
+
+// Swap the root for val, old root into *out; returns 0 when the heap was
+// empty (val is inserted, *out untouched)
+int heap_replace_top(void* ptr, int val, int* out) {
+    return ((heap*)ptr)->replacetop(val, *out) ? 1 : 0;
+}
+
+// Push val and pop the root in one sift; returns the popped value
+int heap_push_pop(void* ptr, int val) {
+    return ((heap*)ptr)->pushpop(val);
+}
+
 void heap_destroy(void* ptr) {
     delete (heap*)ptr;
 }
 
+// Bounded top-k accumulator; largest = 0 keeps the k smallest
+void* topk_create(int k, int largest) {
+    return new topk(k, largest != 0);
+}
+
+void topk_push_batch(void* ptr, int* buf, int n) {
+    ((topk*)ptr)->pushBatch(buf, n);
+}
+
+// Kept values best first into out (k entries); returns how many
+int topk_extract(void* ptr, int* out) {
+    return ((topk*)ptr)->extract(out);
+}
+
+void topk_destroy(void* ptr) {
+    delete (topk*)ptr;
+}
+
+// Merge k sorted runs stored back to back in buf (run r has lens[r]
+// values) into out; mode 0 = ascending, 1 = descending. Returns the count.
+int heap_merge_runs(int* buf, int* lens, int k, int mode, int* out) {
+    const int** runs = new const int*[k > 0 ? k : 1];
+    int total = 0;
+    for (int r = 0; r < k; r++) {
+        runs[r] = buf + total;
+        total += lens[r];
+    }
+    kwaymerge m(runs, lens, k, mode);
+    int n = m.read(out, total);
+    delete[] runs;
+    return n;
+}
+
+// Concurrent sharded queue; shards <= 0 = two per pool thread,
+// mode 0 = min, 1 = max, strict != 0 = exact pop order
+void* multiqueue_create(int shards, int mode, int strict) {
+    return new multiqueue(shards, mode, strict != 0);
+}
+
+void multiqueue_push(void* ptr, int val) {
+    ((multiqueue*)ptr)->push(val);
+}
+
+void multiqueue_push_batch(void* ptr, int* buf, int n) {
+    ((multiqueue*)ptr)->pushBatch(buf, n);
+}
+
+// Popped value into *out; returns 0 when the queue was empty
+int multiqueue_pop(void* ptr, int* out) {
+    return ((multiqueue*)ptr)->pop(*out) ? 1 : 0;
+}
+
+int multiqueue_size(void* ptr) {
+    return ((multiqueue*)ptr)->size();
+}
+
+void multiqueue_destroy(void* ptr) {
+    delete (multiqueue*)ptr;
+}
+
 
 
 // ===============================================================
@@ -119,8 +298,17 @@ void* graph_create(int vertices) {
     return new graph(vertices);
 }
 
-void graph_add_node(void* ptr) {
-    ((graph*)ptr)->addnode();
+// Bulk loaders over a buffer in wasm memory; return null on malformed input.
+void* graph_load_text(const char* buf, int len) {
+    return loadEdgeListText(buf, len);
+}
+
+void* graph_load_binary(const void* buf, int len) {
+    return loadEdgeListBinary(buf, len);
+}
+
+int graph_add_node(void* ptr) {
+    return ((graph*)ptr)->addnode();
 }
 
 void graph_remove_node(void* ptr, int u) {
@@ -143,20 +331,120 @@ int graph_get_vertex_count(void* ptr) {
     return ((graph*)ptr)->getVertexCount();
 }
 
+void graph_set_stable_ids(void* ptr, int on) {
+    ((graph*)ptr)->setStableIds(on != 0);
+}
+
+int graph_is_alive(void* ptr, int u) {
+    return ((graph*)ptr)->isAlive(u) ? 1 : 0;
+}
+
+int graph_get_live_count(void* ptr) {
+    return ((graph*)ptr)->getLiveCount();
+}
+
 int* graph_bfs(void* ptr, int start, int* outCount) {
     return ((graph*)ptr)->BFS(start, *outCount);
 }
 
+// Same order contract as graph_bfs; outLevels may be null or hold V ints.
+int* graph_bfs_parallel(void* ptr, int start, int* outCount, int* outLevels) {
+    return ((graph*)ptr)->BFSDirectionOptimizing(start, *outCount, outLevels);
+}
+
 int* graph_dfs(void* ptr, int start, int* outCount) {
     return ((graph*)ptr)->DFS(start, *outCount);
 }
 
-void graph_dijkstra(void* ptr, int start) {
-    ((graph*)ptr)->dijkstra(start);
+// outDist / outParent must hold graph_get_vertex_count() entries.
+// Returns the number of entries written (0 for an invalid start).
+int graph_dijkstra(void* ptr, int start, double* outDist, int* outParent) {
+    graph* g = (graph*)ptr;
+    if (!g->isAlive(start)) return 0;
+    g->dijkstra(start, outDist, outParent);
+    return g->getVertexCount();
+}
+
+// Same output contract as graph_dijkstra; delta <= 0 picks one automatically.
+int graph_delta_stepping(void* ptr, int start, double delta, double* outDist, int* outParent) {
+    graph* g = (graph*)ptr;
+    if (!g->isAlive(start)) return 0;
+    g->deltastepping(start, delta, outDist, outParent);
+    return g->getVertexCount();
+}
+
+// outEdges holds 2 * (V - 1) ints as (parent, child) pairs, outWeights V - 1.
+// Returns the number of MST edges written.
+int graph_prim(void* ptr, int* outEdges, double* outWeights) {
+    return ((graph*)ptr)->prim(outEdges, outWeights);
+}
+
+// Cached shortest-path trees, maintained incrementally across edits.
+void graph_track_source(void* ptr, int source) {
+    ((graph*)ptr)->trackSource(source);
+}
+
+void graph_untrack_source(void* ptr, int source) {
+    ((graph*)ptr)->untrackSource(source);
+}
+
+double graph_cached_dist(void* ptr, int source, int v) {
+    return ((graph*)ptr)->cachedDist(source, v);
+}
+
+int graph_cached_parent(void* ptr, int source, int v) {
+    return ((graph*)ptr)->cachedParent(source, v);
+}
+
+// mode: 0 = degree, 1 = BFS, 2 = reverse Cuthill-McKee. outNewId[old] and
+// outOldId[new] hold V entries each and may be null.
+void graph_reorder(void* ptr, int mode, int* outNewId, int* outOldId) {
+    ((graph*)ptr)->reorder(mode, outNewId, outOldId);
+}
+
+// xy holds n (x, y) pairs, used by the A* heuristic.
+void graph_set_coords(void* ptr, const double* xy, int n) {
+    ((graph*)ptr)->setCoordinates(xy, n);
+}
+
+// s -> t query with early exit. mode 0 = bidirectional Dijkstra,
+// mode 1 = A* with scale * Euclidean distance. Writes the path to outPath
+// when it fits in cap and returns its vertex count (0 if unreachable).
+int graph_shortest_path(void* ptr, int s, int t, int mode, double scale,
+                        int* outPath, int cap, double* outDist) {
+    graph* g = (graph*)ptr;
+    int len = 0;
+    double d;
+    if (mode == 1) d = g->astarEuclidean(s, t, scale, outPath, cap, len);
+    else d = g->shortestPath(s, t, outPath, cap, len);
+    if (outDist) *outDist = d;
+    return len;
+}
+
+// Minimum spanning forest; same buffers and return value as graph_prim.
+int graph_boruvka(void* ptr, int* outEdges, double* outWeights) {
+    return ((graph*)ptr)->boruvka(outEdges, outWeights);
+}
+
+int graph_kruskal(void* ptr, int* outEdges, double* outWeights) {
+    return ((graph*)ptr)->kruskal(outEdges, outWeights);
+}
+
+void graph_clear_edges(void* ptr) {
+    ((graph*)ptr)->clearEdges();
+}
+
+// outStats[0..3] = edge nodes allocated, freed, live, and slabs (mallocs).
+void graph_alloc_stats(void* ptr, double* outStats) {
+    ((graph*)ptr)->getAllocStats(outStats);
+}
+
+void graph_freeze(void* ptr) {
+    ((graph*)ptr)->freeze();
 }
 
-void graph_prim(void* ptr) {
-    ((graph*)ptr)->prim();
+void graph_unfreeze(void* ptr) {
+    ((graph*)ptr)->unfreeze();
 }
 
 void graph_print(void* ptr) {
@@ -1,34 +1,224 @@
 #pragma once
+#include <stdint.h>
+#include <functional>
+#include <mutex>
+#include <vector>
 
+// Index of a node in its tree's arena. Slot 0 is a shared null node with
+// height 0, so children can be read without checking for null.
+typedef uint32_t avlidx;
+static const avlidx AVLNIL = 0;
+// Bound on AVL height for 2^32 nodes (1.44 log2 n), sizing the path stacks.
+static const int AVLMAXH = 48;
+
+template <class Key>
 class AVLnode {
 public:
-    int data;
-    AVLnode* left;
-    AVLnode* right;
-    int height;
+    Key data;
+    avlidx left;
+    avlidx right;
+    uint32_t size;   // nodes in this subtree
+    uint8_t height;
+};
+
+template <class Key, class Compare>
+class AVLcompiled;
 
-    AVLnode(int dat);
+enum avlsetop {
+    AVL_UNION,
+    AVL_INTERSECTION,
+    AVL_DIFFERENCE
 };
 
+// Ordered set of Key under Compare, a strict weak ordering whose call is
+// resolved (and usually inlined) at compile time. Two keys are equal when
+// neither compares less than the other.
+//
+// Nodes live in one contiguous array and link by 32-bit index. Freed
+// slots are chained through left and reused before the arena grows, and
+// destroying or clearing the tree releases the whole array at once.
+template <class Key, class Compare = std::less<Key> >
 class AVLTree {
 public:
-    AVLnode* root;
-    int balancefactor(AVLnode
-* n);
-    AVLnode* rightrotation(AVLnode
-* x);
-    AVLnode* leftrotation(AVLnode
-* x);
-    AVLnode* insert(AVLnode
-* n, int key);
-    AVLnode* deleteAVL(AVLnode
-* r, int key);
+    AVLnode<Key>* nodes;
+    avlidx cap;
+    avlidx used;      // slots handed out so far, including the null node
+    avlidx freehead;
+    avlidx root;
+    int count;        // live arena nodes; more than size() while old versions hold some
+    Compare cmp;
+
+    // Persistent mode: refs[n] counts the parents and version handles
+    // pointing at node n. Writes go through cow/descend, which copy a
+    // shared node before it is changed, so older versions never see
+    // updates and each insert or delete copies only its O(log n) path.
+    uint32_t* refs;
+    std::vector<avlidx> versions;
+    std::vector<int> freeversions;
+
+    avlidx clone(avlidx n);
+    avlidx cow(avlidx n) { return refs && refs[n] > 1 ? clone(n) : n; }
+    // Child of n on the given side, made private and relinked if shared.
+    avlidx descend(avlidx n, bool right) {
+        avlidx c = right ? nodes[n].right : nodes[n].left;
+        if (refs && refs[c] > 1) {
+            c = clone(c);
+            if (right)
+                nodes[n].right = c;
+            else
+                nodes[n].left = c;
+        }
+        return c;
+    }
+    void addref(avlidx n) { if (n != AVLNIL) refs[n]++; }
+    // Drops one reference to n, freeing whatever is no longer reachable.
+    void dropref(avlidx n);
+
+    // key is taken by value: it may point into the arena, which can move.
+    avlidx newnode(Key key);
+    void freenode(avlidx n);
+    void update(avlidx n);
+    int balancefactor(avlidx n);
+    avlidx rightrotation(avlidx x);
+    avlidx leftrotation(avlidx x);
+    avlidx rebalance(avlidx n);
+    // Rebalances path[depth-1] .. path[0] bottom-up, stopping once a
+    // subtree comes out with its old height.
+    void fixup(avlidx* path, int depth);
+    void reserve(avlidx n);
+    avlidx build(const Key* keys, int lo, int hi);
+    int countbelow(const Key& key, bool inclusive);
+    avlidx selectnode(avlidx t, int k);
+
+    // Join/split work on unshared subtrees of this arena and never allocate, so
+    // disjoint subtrees can be processed on different threads. Only
+    // freeing goes through freelock.
+    std::mutex freelock;
+    avlidx joinright(avlidx l, avlidx k, avlidx r);
+    avlidx joinleft(avlidx l, avlidx k, avlidx r);
+    avlidx splitlast(avlidx t, avlidx& rest);
+    void release(avlidx n);
+    void releasetree(avlidx t);
+    avlidx import(const AVLTree& o, avlidx n);
+    // Keeps, frees or joins the pivot nodes of one split step.
+    avlidx combine(int op, avlidx l, avlidx ma, avlidx mb, avlidx r);
+    avlidx setop(int op, avlidx a, avlidx b);
 
 public:
+    // Every key of l < key of k < every key of r. O(|h(l) - h(r)|).
+    avlidx join(avlidx l, avlidx k, avlidx r);
+    // join without a middle node; l's last node takes its place.
+    avlidx join2(avlidx l, avlidx r);
+    // Splits t into keys < key (l) and keys > key (r) and returns the
+    // node holding key, or AVLNIL. O(log n).
+    avlidx split(avlidx t, const Key& key, avlidx& l, avlidx& r);
+
+    // this = this op other, O(m log(n/m + 1)) for m <= n after copying
+    // other's m nodes into this arena (free slots first, then amortized
+    // doubling); other is left unchanged. In persistent mode the current
+    // version is copied out first, O(n). Large inputs are cut into one
+    // slice per pool thread at common pivot keys and the slices are
+    // combined in parallel.
+    void setoperation(int op, const AVLTree& other);
+    void unionWith(const AVLTree& other) { setoperation(AVL_UNION, other); }
+    void intersectWith(const AVLTree& other) { setoperation(AVL_INTERSECTION, other); }
+    void differenceWith(const AVLTree& other) { setoperation(AVL_DIFFERENCE, other); }
+
     AVLTree();
-    int height(AVLnode
-* n);
-    void insertKey(int key);
-    void deleteKey(int key);
-    AVLnode* getRoot();
+    ~AVLTree();
+    int height(avlidx n);
+    void insertKey(const Key& key);
+    void deleteKey(const Key& key);
+    // Replaces the contents with keys[0..n). Ascending input (duplicates
+    // allowed) is built directly into a perfectly balanced tree in O(n);
+    // anything else falls back to one insert per key.
+    void bulkLoad(const Key* keys, int n);
+
+    // Order statistics from subtree sizes, O(log n) each.
+    // Number of keys less than key.
+    int rank(const Key& key);
+    // k-th smallest key (0-based) in out; false when k is out of range.
+    bool select(int k, Key& out);
+    // Number of keys in [lo, hi].
+    int countRange(const Key& lo, const Key& hi);
+
+    // First node with data >= key (or > key when strict); AVLNIL if none.
+    avlidx lowerbound(const Key& key, bool strict);
+    // Writes the keys in [lo, hi] in ascending order to out, at most cap
+    // of them, and returns how many were written. A full buffer can be
+    // continued just past the last key.
+    int rangeScan(const Key& lo, const Key& hi, Key* out, int cap);
+    // Read-only copy of the current keys in a cache-friendly layout; see
+    // AVLcompiled. Later changes to the tree are not reflected in it.
+    AVLcompiled<Key, Compare>* compile();
+    // Keeps earlier versions alive while the tree changes. Turning it off
+    // releases every version handle.
+    void setPersistent(bool on);
+    bool isPersistent() const { return refs != 0; }
+    // O(1) handle on the current version.
+    int snapshot();
+    // Makes version v current again; later changes fork from it.
+    void checkout(int v);
+    void releaseVersion(int v);
+
+    // Also discards every version.
+    void clear();
+    int size() const { return (int)nodes[root].size; }
+    avlidx getRoot();
+    AVLnode<Key>& node(avlidx n) { return nodes[n]; }
 };
+
+// In-order cursor. It holds the current key rather than a node or a
+// stack, and each step re-descends from the root, so it stays valid across
+// inserts and deletes and costs O(log n) per step.
+template <class Key, class Compare = std::less<Key> >
+class AVLcursor {
+public:
+    AVLTree<Key, Compare>* tree;
+    Key key;
+    bool valid;
+
+    // Positioned at the smallest key.
+    AVLcursor(AVLTree<Key, Compare>* t);
+    // Moves to the first key >= k.
+    void seek(const Key& k);
+    // Moves to the next larger key; false once past the end.
+    bool next();
+};
+
+// Immutable sorted key set in Eytzinger (BFS) order: the children of slot
+// k are 2k and 2k+1, so the top levels of every search share a few cache
+// lines and the next levels can be prefetched. Searches are branchless.
+template <class Key, class Compare = std::less<Key> >
+class AVLcompiled {
+public:
+    int n;
+    Key* keys;   // 1-based, 64-byte aligned
+    Key* raw;
+    Compare cmp;
+
+    // sorted must be strictly ascending.
+    AVLcompiled(const Key* sorted, int count);
+    ~AVLcompiled();
+
+    bool contains(const Key& key) const;
+    // Smallest key >= key in out; false if there is none.
+    bool lowerBound(const Key& key, Key& out) const;
+    // out[i] = 1 if q[i] is present, else 0. Runs several searches in
+    // lockstep so their cache misses overlap. Returns how many were found.
+    int containsBatch(const Key* q, int m, int* out) const;
+
+private:
+    int search(const Key& key) const;
+    int fill(const Key* sorted, int i, int k);
+};
+
+#include "AVLimpl.h"
+#include "AVLjoin.h"
+#include "AVLcompiled.h"
+#include "AVLpersist.h"
+
+// The int tree behind the WASM bindings is compiled once, in AVL.cpp.
+extern template class AVLTree<int>;
+extern template class AVLcursor<int>;
+extern template class AVLcompiled<int>;
@@ -0,0 +1,105 @@
+#pragma once
+#include "AVL.h"
+#include <stdint.h>
+
+// Searches run in groups of this many for containsBatch.
+static const int AVLBATCH = 8;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVL_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define AVL_PREFETCH(p) ((void)0)
+#endif
+
+// After descending past the leaves, k's trailing one bits count the
+// right turns taken since the last left turn; dropping them and one more
+// bit lands on that last node where key <= keys[k], the lower bound.
+static inline int avlsettle(int k) {
+    while (k & 1) k >>= 1;
+    return k >> 1;
+}
+
+// keys starts at the first slot of raw that sits on a 64-byte boundary
+// (when Key's size allows one), so slots 16k..16k+15 of 4-byte keys
+// share a cache line.
+template <class Key, class Compare>
+AVLcompiled<Key, Compare>::AVLcompiled(const Key* sorted, int count) {
+    n = count;
+    int pad = 64 / sizeof(Key) + 1;
+    raw = new Key[n + 1 + pad];
+    keys = raw;
+    for (int i = 0; i < pad; i++)
+        if (((uintptr_t)(raw + i) & 63) == 0) {
+            keys = raw + i;
+            break;
+        }
+    fill(sorted, 0, 1);
+}
+
+template <class Key, class Compare>
+AVLcompiled<Key, Compare>::~AVLcompiled() {
+    delete[] raw;
+}
+
+// In-order walk of the implicit tree places the sorted keys.
+template <class Key, class Compare>
+int AVLcompiled<Key, Compare>::fill(const Key* sorted, int i, int k) {
+    if (k > n) return i;
+    i = fill(sorted, i, 2 * k);
+    keys[k] = sorted[i++];
+    return fill(sorted, i, 2 * k + 1);
+}
+
+// Slot of the lower bound of key, 0 if every key is smaller. Descendants
+// four levels down are 16 consecutive slots and are prefetched each step.
+template <class Key, class Compare>
+int AVLcompiled<Key, Compare>::search(const Key& key) const {
+    int k = 1;
+    while (k <= n) {
+        AVL_PREFETCH(keys + 16 * k);
+        k = 2 * k + cmp(keys[k], key);
+    }
+    return avlsettle(k);
+}
+
+template <class Key, class Compare>
+bool AVLcompiled<Key, Compare>::contains(const Key& key) const {
+    int k = search(key);
+    return k != 0 && !cmp(key, keys[k]);
+}
+
+template <class Key, class Compare>
+bool AVLcompiled<Key, Compare>::lowerBound(const Key& key, Key& out) const {
+    int k = search(key);
+    if (k == 0) return false;
+    out = keys[k];
+    return true;
+}
+
+template <class Key, class Compare>
+int AVLcompiled<Key, Compare>::containsBatch(const Key* q, int m, int* out) const {
+    int depth = 0;
+    for (int x = n; x; x >>= 1) depth++;
+
+    int found = 0;
+    for (int base = 0; base < m; base += AVLBATCH) {
+        int g = m - base < AVLBATCH ? m - base : AVLBATCH;
+        int k[AVLBATCH];
+        for (int j = 0; j < g; j++) k[j] = 1;
+        // Leaves sit on the last two levels, so depth steps take every
+        // search past them; a search that got there early just waits.
+        for (int level = 0; level < depth; level++) {
+            for (int j = 0; j < g; j++) {
+                if (k[j] > n) continue;
+                AVL_PREFETCH(keys + 16 * k[j]);
+                k[j] = 2 * k[j] + cmp(keys[k[j]], q[base + j]);
+            }
+        }
+        for (int j = 0; j < g; j++) {
+            int s = avlsettle(k[j]);
+            out[base + j] = s != 0 && !cmp(q[base + j], keys[s]);
+            found += out[base + j];
+        }
+    }
+    return found;
+}
@@ -0,0 +1,425 @@
+#pragma once
+#include "AVL.h"
+
+static const avlidx AVLARENAMIN = 16;
+
+template <class Key, class Compare>
+AVLTree<Key, Compare>::AVLTree() {
+    cap = AVLARENAMIN;
+    nodes = new AVLnode<Key>[cap];
+    nodes[AVLNIL].data = Key();
+    nodes[AVLNIL].left = nodes[AVLNIL].right = AVLNIL;
+    nodes[AVLNIL].size = 0;
+    nodes[AVLNIL].height = 0;
+    used = 1;
+    freehead = AVLNIL;
+    root = AVLNIL;
+    count = 0;
+    refs = 0;
+}
+
+template <class Key, class Compare>
+AVLTree<Key, Compare>::~AVLTree() {
+    delete[] nodes;
+    delete[] refs;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::clear() {
+    versions.clear();
+    freeversions.clear();
+    used = 1;
+    freehead = AVLNIL;
+    root = AVLNIL;
+    count = 0;
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::newnode(Key key) {
+    avlidx n;
+    if (freehead != AVLNIL) {
+        n = freehead;
+        freehead = nodes[n].left;
+    } else {
+        if (used == cap) reserve(2 * cap);
+        n = used++;
+    }
+    nodes[n].data = key;
+    nodes[n].left = AVLNIL;
+    nodes[n].right = AVLNIL;
+    nodes[n].size = 1;
+    nodes[n].height = 1;
+    if (refs) refs[n] = 1;
+    count++;
+    return n;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::freenode(avlidx n) {
+    nodes[n].left = freehead;
+    freehead = n;
+    count--;
+}
+
+template <class Key, class Compare>
+int AVLTree<Key, Compare>::height(avlidx n) {
+    return nodes[n].height;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::update(avlidx n) {
+    nodes[n].size = nodes[nodes[n].left].size + nodes[nodes[n].right].size + 1;
+    int hl = nodes[nodes[n].left].height;
+    int hr = nodes[nodes[n].right].height;
+    nodes[n].height = (uint8_t)((hl > hr ? hl : hr) + 1);
+}
+
+template <class Key, class Compare>
+int AVLTree<Key, Compare>::balancefactor(avlidx n) {
+    if (n == AVLNIL) return 0;
+    return height(nodes[n].left) - height(nodes[n].right);
+}
+
+// Rotations write to x and its rising child, so both are made private
+// first in persistent mode; the moved grandchild keeps its single parent.
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::rightrotation(avlidx x) {
+    x = cow(x);
+    avlidx temp = cow(nodes[x].left);
+    avlidx temp2 = nodes[temp].right;
+
+    nodes[x].left = temp2;
+    nodes[temp].right = x;
+
+    update(x);
+    update(temp);
+    return temp;
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::leftrotation(avlidx x) {
+    x = cow(x);
+    avlidx temp = cow(nodes[x].right);
+    avlidx temp2 = nodes[temp].left;
+
+    nodes[x].right = temp2;
+    nodes[temp].left = x;
+
+    update(x);
+    update(temp);
+    return temp;
+}
+
+template <class Key, class Compare>
+int AVLTree<Key, Compare>::countbelow(const Key& key, bool inclusive) {
+    int below = 0;
+    avlidx n = root;
+    while (n != AVLNIL) {
+        if (cmp(key, nodes[n].data) || (!inclusive && !cmp(nodes[n].data, key))) {
+            n = nodes[n].left;
+        } else {
+            below += nodes[nodes[n].left].size + 1;
+            n = nodes[n].right;
+        }
+    }
+    return below;
+}
+
+template <class Key, class Compare>
+int AVLTree<Key, Compare>::rank(const Key& key) {
+    return countbelow(key, false);
+}
+
+// k must be below the size of t.
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::selectnode(avlidx t, int k) {
+    for (;;) {
+        int ls = nodes[nodes[t].left].size;
+        if (k < ls) {
+            t = nodes[t].left;
+        } else if (k == ls) {
+            return t;
+        } else {
+            k -= ls + 1;
+            t = nodes[t].right;
+        }
+    }
+}
+
+template <class Key, class Compare>
+bool AVLTree<Key, Compare>::select(int k, Key& out) {
+    if (k < 0 || k >= size()) return false;
+    out = nodes[selectnode(root, k)].data;
+    return true;
+}
+
+template <class Key, class Compare>
+int AVLTree<Key, Compare>::countRange(const Key& lo, const Key& hi) {
+    if (cmp(hi, lo)) return 0;
+    return countbelow(hi, true) - countbelow(lo, false);
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::lowerbound(const Key& key, bool strict) {
+    avlidx best = AVLNIL;
+    avlidx n = root;
+    while (n != AVLNIL) {
+        if (cmp(key, nodes[n].data) || (!strict && !cmp(nodes[n].data, key))) {
+            best = n;
+            n = nodes[n].left;
+        } else {
+            n = nodes[n].right;
+        }
+    }
+    return best;
+}
+
+// The stack holds the ancestors still to be visited, never more than the
+// tree height.
+template <class Key, class Compare>
+int AVLTree<Key, Compare>::rangeScan(const Key& lo, const Key& hi, Key* out, int cap) {
+    if (cmp(hi, lo) || cap <= 0) return 0;
+    avlidx stack[AVLMAXH];
+    int depth = 0;
+    int written = 0;
+    avlidx n = root;
+    while (n != AVLNIL) {
+        if (cmp(nodes[n].data, lo)) {
+            n = nodes[n].right;
+        } else {
+            stack[depth++] = n;
+            n = nodes[n].left;
+        }
+    }
+    while (depth > 0 && written < cap) {
+        n = stack[--depth];
+        if (cmp(hi, nodes[n].data)) break;
+        out[written++] = nodes[n].data;
+        for (n = nodes[n].right; n != AVLNIL; n = nodes[n].left) stack[depth++] = n;
+    }
+    return written;
+}
+
+template <class Key, class Compare>
+AVLcompiled<Key, Compare>* AVLTree<Key, Compare>::compile() {
+    int total = size();
+    Key* sorted = new Key[total > 0 ? total : 1];
+    int n = 0;
+    avlidx stack[AVLMAXH];
+    int depth = 0;
+    for (avlidx x = root; x != AVLNIL; x = nodes[x].left) stack[depth++] = x;
+    while (depth > 0) {
+        avlidx x = stack[--depth];
+        sorted[n++] = nodes[x].data;
+        for (x = nodes[x].right; x != AVLNIL; x = nodes[x].left) stack[depth++] = x;
+    }
+    AVLcompiled<Key, Compare>* c = new AVLcompiled<Key, Compare>(sorted, n);
+    delete[] sorted;
+    return c;
+}
+
+// Restores the AVL property at n (whose children are balanced) and
+// returns the new subtree root.
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::rebalance(avlidx n) {
+    update(n);
+
+    int balance = balancefactor(n);
+
+    if (balance > 1) {
+        if (balancefactor(nodes[n].left) < 0)
+            nodes[n].left = leftrotation(nodes[n].left);
+        return rightrotation(n);
+    }
+
+    if (balance < -1) {
+        if (balancefactor(nodes[n].right) > 0)
+            nodes[n].right = rightrotation(nodes[n].right);
+        return leftrotation(n);
+    }
+
+    return n;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::fixup(avlidx* path, int depth) {
+    for (int i = depth - 1; i >= 0; i--) {
+        avlidx n = path[i];
+        int old = nodes[n].height;
+        avlidx r = rebalance(n);
+        if (i == 0)
+            root = r;
+        else if (nodes[path[i - 1]].left == n)
+            nodes[path[i - 1]].left = r;
+        else
+            nodes[path[i - 1]].right = r;
+        if (nodes[r].height == old) {
+            // Heights above are settled; only the sizes still change.
+            for (int j = i - 1; j >= 0; j--) {
+                avlidx a = path[j];
+                nodes[a].size = nodes[nodes[a].left].size + nodes[nodes[a].right].size + 1;
+            }
+            break;
+        }
+    }
+}
+
+// In persistent mode every node on the way down is made private (see
+// descend), so the rebalancing below only ever writes to nodes of the
+// current version. A missing or duplicate key is checked first so that
+// no-ops copy nothing.
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::insertKey(const Key& key) {
+    if (refs) {
+        avlidx f = lowerbound(key, false);
+        if (f != AVLNIL && !cmp(key, nodes[f].data)) return;
+        root = cow(root);
+    }
+    avlidx path[AVLMAXH];
+    int depth = 0;
+    avlidx n = root;
+    while (n != AVLNIL) {
+        bool less = cmp(key, nodes[n].data);
+        if (!less && !cmp(nodes[n].data, key)) return;
+        path[depth++] = n;
+        n = descend(n, !less);
+    }
+
+    avlidx x = newnode(key);
+    if (depth == 0) {
+        root = x;
+        return;
+    }
+    avlidx p = path[depth - 1];
+    if (cmp(key, nodes[p].data))
+        nodes[p].left = x;
+    else
+        nodes[p].right = x;
+    fixup(path, depth);
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::deleteKey(const Key& key) {
+    if (refs) {
+        avlidx f = lowerbound(key, false);
+        if (f == AVLNIL || cmp(key, nodes[f].data)) return;
+        root = cow(root);
+    }
+    avlidx path[AVLMAXH];
+    int depth = 0;
+    avlidx n = root;
+    while (n != AVLNIL) {
+        bool less = cmp(key, nodes[n].data);
+        if (!less && !cmp(nodes[n].data, key)) break;
+        path[depth++] = n;
+        n = descend(n, !less);
+    }
+    if (n == AVLNIL) return;
+
+    // With two children, the in-order successor's key moves up into n and
+    // the successor (which has no left child) is unlinked instead.
+    avlidx z = n;
+    if (nodes[n].left != AVLNIL && nodes[n].right != AVLNIL) {
+        path[depth++] = n;
+        z = descend(n, true);
+        while (nodes[z].left != AVLNIL) {
+            path[depth++] = z;
+            z = descend(z, false);
+        }
+        nodes[n].data = nodes[z].data;
+    }
+
+    avlidx child = nodes[z].left != AVLNIL ? nodes[z].left : nodes[z].right;
+    if (depth == 0)
+        root = child;
+    else if (nodes[path[depth - 1]].left == z)
+        nodes[path[depth - 1]].left = child;
+    else
+        nodes[path[depth - 1]].right = child;
+    freenode(z);
+    fixup(path, depth);
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::reserve(avlidx n) {
+    if (n <= cap) return;
+    AVLnode<Key>* grown = new AVLnode<Key>[n];
+    for (avlidx i = 0; i < used; i++) grown[i] = nodes[i];
+    delete[] nodes;
+    nodes = grown;
+    if (refs) {
+        uint32_t* r = new uint32_t[n];
+        for (avlidx i = 0; i < used; i++) r[i] = refs[i];
+        delete[] refs;
+        refs = r;
+    }
+    cap = n;
+}
+
+// Middle key becomes the root, so both halves differ in size by at most
+// one and every subtree is perfectly balanced.
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::build(const Key* keys, int lo, int hi) {
+    if (lo >= hi) return AVLNIL;
+    int mid = lo + (hi - lo) / 2;
+    avlidx n = newnode(keys[mid]);
+    avlidx l = build(keys, lo, mid);
+    avlidx r = build(keys, mid + 1, hi);
+    nodes[n].left = l;
+    nodes[n].right = r;
+    update(n);
+    return n;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::bulkLoad(const Key* keys, int n) {
+    clear();
+    bool sorted = true;
+    for (int i = 1; i < n && sorted; i++)
+        if (cmp(keys[i], keys[i - 1])) sorted = false;
+    if (!sorted) {
+        for (int i = 0; i < n; i++) insertKey(keys[i]);
+        return;
+    }
+
+    Key* unique = new Key[n > 0 ? n : 1];
+    int m = 0;
+    for (int i = 0; i < n; i++)
+        if (m == 0 || cmp(unique[m - 1], keys[i])) unique[m++] = keys[i];
+    reserve((avlidx)m + 1);
+    root = build(unique, 0, m);
+    delete[] unique;
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::getRoot() {
+    return root;
+}
+
+template <class Key, class Compare>
+AVLcursor<Key, Compare>::AVLcursor(AVLTree<Key, Compare>* t) {
+    tree = t;
+    key = Key();
+    valid = false;
+    avlidx n = t->root;
+    if (n == AVLNIL) return;
+    while (t->nodes[n].left != AVLNIL) n = t->nodes[n].left;
+    key = t->nodes[n].data;
+    valid = true;
+}
+
+template <class Key, class Compare>
+void AVLcursor<Key, Compare>::seek(const Key& k) {
+    avlidx n = tree->lowerbound(k, false);
+    valid = n != AVLNIL;
+    if (valid) key = tree->nodes[n].data;
+}
+
+template <class Key, class Compare>
+bool AVLcursor<Key, Compare>::next() {
+    if (!valid) return false;
+    avlidx n = tree->lowerbound(key, true);
+    valid = n != AVLNIL;
+    if (valid) key = tree->nodes[n].data;
+    return valid;
+}
@@ -0,0 +1,233 @@
+#pragma once
+#include "AVL.h"
+#include "threadpool.h"
+#include <vector>
+
+// Below this many keys in total the set operations stay on one thread.
+static const int AVLSETOPPARALLEL = 1 << 14;
+
+// l is the taller side: walk down its right spine to a subtree no more
+// than one level taller than r, hang l' < k < r there and rebalance on
+// the way back up.
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::joinright(avlidx l, avlidx k, avlidx r) {
+    avlidx c = nodes[l].right;
+    if (nodes[c].height <= nodes[r].height + 1) {
+        nodes[k].left = c;
+        nodes[k].right = r;
+        update(k);
+        nodes[l].right = k;
+    } else {
+        avlidx j = joinright(c, k, r);
+        nodes[l].right = j;
+    }
+    return rebalance(l);
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::joinleft(avlidx l, avlidx k, avlidx r) {
+    avlidx c = nodes[r].left;
+    if (nodes[c].height <= nodes[l].height + 1) {
+        nodes[k].left = l;
+        nodes[k].right = c;
+        update(k);
+        nodes[r].left = k;
+    } else {
+        avlidx j = joinleft(l, k, c);
+        nodes[r].left = j;
+    }
+    return rebalance(r);
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::join(avlidx l, avlidx k, avlidx r) {
+    int hl = nodes[l].height;
+    int hr = nodes[r].height;
+    if (hl > hr + 1) return joinright(l, k, r);
+    if (hr > hl + 1) return joinleft(l, k, r);
+    nodes[k].left = l;
+    nodes[k].right = r;
+    update(k);
+    return k;
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::splitlast(avlidx t, avlidx& rest) {
+    avlidx r = nodes[t].right;
+    if (r == AVLNIL) {
+        rest = nodes[t].left;
+        return t;
+    }
+    avlidx tail;
+    avlidx last = splitlast(r, tail);
+    rest = join(nodes[t].left, t, tail);
+    return last;
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::join2(avlidx l, avlidx r) {
+    if (l == AVLNIL) return r;
+    avlidx rest;
+    avlidx k = splitlast(l, rest);
+    return join(rest, k, r);
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::split(avlidx t, const Key& key, avlidx& l, avlidx& r) {
+    if (t == AVLNIL) {
+        l = r = AVLNIL;
+        return AVLNIL;
+    }
+    avlidx tl = nodes[t].left;
+    avlidx tr = nodes[t].right;
+    bool less = cmp(key, nodes[t].data);
+    if (!less && !cmp(nodes[t].data, key)) {
+        l = tl;
+        r = tr;
+        return t;
+    }
+    avlidx m;
+    if (less) {
+        avlidx rl;
+        m = split(tl, key, l, rl);
+        r = join(rl, t, tr);
+    } else {
+        avlidx lr;
+        m = split(tr, key, lr, r);
+        l = join(tl, t, lr);
+    }
+    return m;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::release(avlidx n) {
+    std::lock_guard<std::mutex> lk(freelock);
+    freenode(n);
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::releasetree(avlidx t) {
+    if (t == AVLNIL) return;
+    avlidx stack[AVLMAXH + 1];
+    int depth = 0;
+    std::lock_guard<std::mutex> lk(freelock);
+    stack[depth++] = t;
+    while (depth > 0) {
+        avlidx n = stack[--depth];
+        // Children are read before freenode reuses left as the link.
+        if (nodes[n].right != AVLNIL) stack[depth++] = nodes[n].right;
+        if (nodes[n].left != AVLNIL) stack[depth++] = nodes[n].left;
+        freenode(n);
+    }
+}
+
+// Copies o's subtree n into this arena, shape and all. The caller reserves
+// room first.
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::import(const AVLTree& o, avlidx n) {
+    if (n == AVLNIL) return AVLNIL;
+    avlidx x = newnode(o.nodes[n].data);
+    avlidx l = import(o, o.nodes[n].left);
+    avlidx r = import(o, o.nodes[n].right);
+    nodes[x].left = l;
+    nodes[x].right = r;
+    nodes[x].size = o.nodes[n].size;
+    nodes[x].height = o.nodes[n].height;
+    return x;
+}
+
+// ma and mb hold the same key from either side (either may be AVLNIL).
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::combine(int op, avlidx l, avlidx ma, avlidx mb, avlidx r) {
+    avlidx keep;
+    if (op == AVL_UNION)
+        keep = ma != AVLNIL ? ma : mb;
+    else if (op == AVL_INTERSECTION)
+        keep = ma != AVLNIL && mb != AVLNIL ? ma : AVLNIL;
+    else
+        keep = ma != AVLNIL && mb == AVLNIL ? ma : AVLNIL;
+    if (ma != AVLNIL && ma != keep) release(ma);
+    if (mb != AVLNIL && mb != keep) release(mb);
+    return keep != AVLNIL ? join(l, keep, r) : join2(l, r);
+}
+
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::setop(int op, avlidx a, avlidx b) {
+    if (a == AVLNIL) {
+        if (op == AVL_UNION) return b;
+        releasetree(b);
+        return AVLNIL;
+    }
+    if (b == AVLNIL) {
+        if (op != AVL_INTERSECTION) return a;
+        releasetree(a);
+        return AVLNIL;
+    }
+    avlidx al = nodes[a].left;
+    avlidx ar = nodes[a].right;
+    avlidx bl, br;
+    avlidx mb = split(b, nodes[a].data, bl, br);
+    avlidx l = setop(op, al, bl);
+    avlidx r = setop(op, ar, br);
+    return combine(op, l, a, mb, r);
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::setoperation(int op, const AVLTree& other) {
+    if (&other == this) {
+        if (op == AVL_DIFFERENCE) clear();
+        return;
+    }
+    // Room for what import copies: other's current version, plus ours
+    // when persistent. Free-list slots are used first; past those the
+    // arena at least doubles, as in newnode.
+    avlidx need = other.nodes[other.root].size;
+    if (refs) need += nodes[root].size;
+    avlidx spare = used - 1 - (avlidx)count;
+    if (need > spare) {
+        avlidx want = used + (need - spare);
+        if (want > cap) reserve(want > 2 * cap ? want : 2 * cap);
+    }
+    avlidx a = root;
+    if (refs) {
+        // Join and split relink nodes in place, so the current version
+        // gets a private copy and older versions keep the originals.
+        a = import(*this, root);
+        dropref(root);
+    }
+    avlidx b = import(other, other.root);
+
+    threadpool& pool = threadpool::shared();
+    int parts = pool.size();
+    int total = (int)(nodes[a].size + nodes[b].size);
+    if (total < AVLSETOPPARALLEL) parts = 1;
+
+    if (parts == 1) {
+        root = setop(op, a, b);
+    } else {
+        // Pivots at even ranks of the larger tree cut both inputs into
+        // independent slices; the pivot keys themselves are set aside.
+        avlidx big = nodes[a].size >= nodes[b].size ? a : b;
+        int bigsize = (int)nodes[big].size;
+        std::vector<Key> pivots;
+        for (int i = 1; i < parts; i++)
+            pivots.push_back(nodes[selectnode(big, (int)((long long)bigsize * i / parts))].data);
+
+        std::vector<avlidx> sa(parts), sb(parts), ma(parts - 1), mb(parts - 1);
+        for (int i = 0; i < parts - 1; i++) {
+            ma[i] = split(a, pivots[i], sa[i], a);
+            mb[i] = split(b, pivots[i], sb[i], b);
+        }
+        sa[parts - 1] = a;
+        sb[parts - 1] = b;
+
+        std::vector<avlidx> res(parts);
+        pool.parallelfor(parts, 1, [&](int lo, int hi, int) {
+            for (int i = lo; i < hi; i++) res[i] = setop(op, sa[i], sb[i]);
+        });
+
+        avlidx r = res[0];
+        for (int i = 0; i < parts - 1; i++) r = combine(op, r, ma[i], mb[i], res[i + 1]);
+        root = r;
+    }
+}
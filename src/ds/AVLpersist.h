@@ -0,0 +1,84 @@
+#pragma once
+#include "AVL.h"
+
+// Unused version slots hold this instead of a root.
+static const avlidx AVLRELEASED = 0xffffffffu;
+
+// The copy takes over one of n's references (the parent about to be
+// relinked to it) and adds one to each child, now shared by both.
+template <class Key, class Compare>
+avlidx AVLTree<Key, Compare>::clone(avlidx n) {
+    avlidx c = newnode(nodes[n].data);
+    nodes[c] = nodes[n];
+    addref(nodes[c].left);
+    addref(nodes[c].right);
+    refs[n]--;
+    return c;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::dropref(avlidx n) {
+    if (n == AVLNIL || --refs[n] > 0) return;
+    // Every version is itself an AVL tree, so the stack stays within
+    // one path plus the pending right siblings along it.
+    avlidx stack[AVLMAXH + 1];
+    int depth = 0;
+    stack[depth++] = n;
+    while (depth > 0) {
+        avlidx x = stack[--depth];
+        avlidx l = nodes[x].left;
+        avlidx r = nodes[x].right;
+        freenode(x);
+        if (r != AVLNIL && --refs[r] == 0) stack[depth++] = r;
+        if (l != AVLNIL && --refs[l] == 0) stack[depth++] = l;
+    }
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::setPersistent(bool on) {
+    if (on == (refs != 0)) return;
+    if (on) {
+        // Without versions every node has exactly one parent.
+        refs = new uint32_t[cap];
+        refs[AVLNIL] = 0;
+        for (avlidx i = 1; i < cap; i++) refs[i] = 1;
+        return;
+    }
+    for (size_t v = 0; v < versions.size(); v++)
+        if (versions[v] != AVLRELEASED) dropref(versions[v]);
+    versions.clear();
+    freeversions.clear();
+    delete[] refs;
+    refs = 0;
+}
+
+template <class Key, class Compare>
+int AVLTree<Key, Compare>::snapshot() {
+    if (!refs) setPersistent(true);
+    addref(root);
+    if (!freeversions.empty()) {
+        int v = freeversions.back();
+        freeversions.pop_back();
+        versions[v] = root;
+        return v;
+    }
+    versions.push_back(root);
+    return (int)versions.size() - 1;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::checkout(int v) {
+    if (!refs || v < 0 || v >= (int)versions.size() || versions[v] == AVLRELEASED) return;
+    avlidx r = versions[v];
+    addref(r);
+    dropref(root);
+    root = r;
+}
+
+template <class Key, class Compare>
+void AVLTree<Key, Compare>::releaseVersion(int v) {
+    if (!refs || v < 0 || v >= (int)versions.size() || versions[v] == AVLRELEASED) return;
+    dropref(versions[v]);
+    versions[v] = AVLRELEASED;
+    freeversions.push_back(v);
+}
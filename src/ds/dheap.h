@@ -0,0 +1,124 @@
+#pragma once
+#include <stdint.h>
+#include <functional>
+
+// Growable d-ary heap. The element that compares first under Compare sits
+// on top, so std::less gives a min-heap and std::greater a max-heap. D is
+// fixed at compile time (2, 4 and 8 are the useful values); wider nodes
+// make the tree shallower at the cost of more compares per level, which
+// pays off when pops dominate.
+//
+// Logical slot i lives at physical slot i + D - 1 of a 64-byte aligned
+// block, which puts the children of i (D*i + 1 .. D*i + D) at physical
+// slots D*(i + 1) .. D*(i + 1) + D - 1: one aligned group, and a single
+// cache line whenever D * sizeof(T) <= 64.
+template <class T, class Compare = std::less<T>, int D = 4>
+class dheap {
+public:
+    T* raw;
+    T* a;        // logical slot 0
+    int n;
+    int cap;
+    Compare cmp;
+
+    dheap(int initial = 16) {
+        raw = 0;
+        a = 0;
+        n = 0;
+        cap = 0;
+        reserve(initial);
+    }
+
+    ~dheap() {
+        delete[] raw;
+    }
+
+    int size() const { return n; }
+    bool empty() const { return n == 0; }
+    const T& top() const { return a[0]; }
+    const T& operator[](int i) const { return a[i]; }
+    void clear() { n = 0; }
+
+    void reserve(int want) {
+        if (want <= cap) return;
+        int grown = cap > 0 ? cap : 16;
+        while (grown < want) grown *= 2;
+        // Room for the D - 1 leading slots plus up to a line of padding.
+        int pad = (int)(64 / sizeof(T)) + 1;
+        T* r = new T[grown + D - 1 + pad];
+        T* base = r;
+        for (int i = 0; i < pad; i++)
+            if (((uintptr_t)(r + i) & 63) == 0) {
+                base = r + i;
+                break;
+            }
+        T* na = base + D - 1;
+        for (int i = 0; i < n; i++) na[i] = a[i];
+        delete[] raw;
+        raw = r;
+        a = na;
+        cap = grown;
+    }
+
+    void push(const T& v) {
+        if (n == cap) {
+            T copy = v;   // v may live in the block being replaced
+            reserve(n + 1);
+            a[n] = copy;
+        } else {
+            a[n] = v;
+        }
+        siftup(n++);
+    }
+
+    // Swaps the top for v in a single sift; the heap must not be empty.
+    void replacetop(const T& v) {
+        a[0] = v;
+        siftdown(0);
+    }
+
+    void pop() {
+        if (n == 0) return;
+        n--;
+        if (n > 0) {
+            a[0] = a[n];
+            siftdown(0);
+        }
+    }
+
+    // Restores the heap over a[0..n) bottom-up (Floyd) in O(n), for
+    // callers that filled the array directly.
+    void heapify() {
+        if (n < 2) return;
+        for (int i = (n - 2) / D; i >= 0; i--) siftdown(i);
+    }
+
+    // Moves the element at i up until its parent comes first. Holes are
+    // shifted instead of swapping at every level.
+    void siftup(int i) {
+        T v = a[i];
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (!cmp(v, a[p])) break;
+            a[i] = a[p];
+            i = p;
+        }
+        a[i] = v;
+    }
+
+    void siftdown(int i) {
+        T v = a[i];
+        for (;;) {
+            int first = D * i + 1;
+            if (first >= n) break;
+            int best = first;
+            int last = first + D < n ? first + D : n;
+            for (int c = first + 1; c < last; c++)
+                if (cmp(a[c], a[best])) best = c;
+            if (!cmp(a[best], v)) break;
+            a[i] = a[best];
+            i = best;
+        }
+        a[i] = v;
+    }
+};
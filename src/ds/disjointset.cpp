@@ -0,0 +1,43 @@
+#include "disjointset.h"
+
+disjointset::disjointset(int size) {
+    n = size;
+    parent = new int[n > 0 ? n : 1];
+    rank = new int[n > 0 ? n : 1];
+    for (int i = 0; i < n; i++) {
+        parent[i] = i;
+        rank[i] = 0;
+    }
+}
+
+disjointset::~disjointset() {
+    delete[] parent;
+    delete[] rank;
+}
+
+int disjointset::find(int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+int disjointset::findconst(int x) const {
+    while (parent[x] != x) x = parent[x];
+    return x;
+}
+
+bool disjointset::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (rank[a] < rank[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    parent[b] = a;
+    if (rank[a] == rank[b]) rank[a]++;
+    return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// Union-find with union by rank and path halving.
+class disjointset {
+public:
+    int n;
+    int* parent;
+    int* rank;
+
+    disjointset(int size);
+    ~disjointset();
+
+    int find(int x);
+    // Root of x without compressing the path; safe to call from several
+    // threads while nobody unites.
+    int findconst(int x) const;
+    // Returns false when a and b were already in the same set.
+    bool unite(int a, int b);
+};
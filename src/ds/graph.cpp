@@ -1,70 +1,437 @@
 #include "graph.h"
+#include <limits>
 using namespace std;
 
+static const double INF = numeric_limits<double>::infinity();
+
+graphscratch::graphscratch() {
+    cap = 0;
+    key = 0;
+    parent = 0;
+    visited = 0;
+    key2 = 0;
+    parent2 = 0;
+    seen = 0;
+    seen2 = 0;
+    stamp = 0;
+}
+
+graphscratch::~graphscratch() {
+    delete[] key;
+    delete[] parent;
+    delete[] visited;
+    delete[] key2;
+    delete[] parent2;
+    delete[] seen;
+    delete[] seen2;
+}
+
+void graphscratch::reserve(int n) {
+    if (n <= cap) return;
+    int c = cap ? cap : 16;
+    while (c < n) c *= 2;
+    delete[] key;
+    delete[] parent;
+    delete[] visited;
+    delete[] key2;
+    delete[] parent2;
+    delete[] seen;
+    delete[] seen2;
+    key = new double[c];
+    parent = new int[c];
+    visited = new bool[c];
+    key2 = new double[c];
+    parent2 = new int[c];
+    seen = new int[c];
+    seen2 = new int[c];
+    for (int i = 0; i < c; i++) seen[i] = seen2[i] = 0;
+    stamp = 0;
+    cap = c;
+}
+
+int graphscratch::nextstamp() {
+    if (stamp == numeric_limits<int>::max()) {
+        for (int i = 0; i < cap; i++) seen[i] = seen2[i] = 0;
+        stamp = 0;
+    }
+    return ++stamp;
+}
+
 singlenode::singlenode(int val, double w) {
     vertex = val;
     weight = w;
     nextnode = 0;
 }
 
+static const int SLABMIN = 64;
+static const int SLABMAX = 1 << 16;
+
+edgepool::edgepool() {
+    slabs = 0;
+    cursor = 0;
+    end = 0;
+    freehead = 0;
+    nextslab = SLABMIN;
+    allocs = 0;
+    frees = 0;
+    slabcount = 0;
+}
+
+edgepool::~edgepool() {
+    clear();
+}
+
+// Slab memory is raw: singlenode has no destructor, and every field is
+// written before a node is handed out.
+singlenode* edgepool::newslab(int n) {
+    slab* sl = new slab;
+    sl->nodes = static_cast<singlenode*>(::operator new(sizeof(singlenode) * (size_t)n));
+    sl->next = slabs;
+    slabs = sl;
+    slabcount++;
+    return sl->nodes;
+}
+
+singlenode* edgepool::alloc(int v, double w) {
+    singlenode* n;
+    if (freehead) {
+        n = freehead;
+        freehead = n->nextnode;
+    } else {
+        if (cursor == end) {
+            cursor = newslab(nextslab);
+            end = cursor + nextslab;
+            if (nextslab < SLABMAX) nextslab *= 2;
+        }
+        n = cursor++;
+    }
+    n->vertex = v;
+    n->weight = w;
+    n->nextnode = 0;
+    allocs++;
+    return n;
+}
+
+void edgepool::release(singlenode* n) {
+    n->nextnode = freehead;
+    freehead = n;
+    frees++;
+}
+
+singlenode* edgepool::allocrun(int n) {
+    allocs += n;
+    return newslab(n > 0 ? n : 1);
+}
+
+void edgepool::clear() {
+    while (slabs) {
+        slab* sl = slabs;
+        slabs = sl->next;
+        ::operator delete(sl->nodes);
+        delete sl;
+    }
+    frees = allocs;
+    cursor = end = freehead = 0;
+    nextslab = SLABMIN;
+}
+
+graphcsr::graphcsr(int v, int e) {
+    V = v;
+    E = e;
+    offsets = new int[V + 1];
+    targets = new int[E];
+    weights = new double[E];
+}
+
+graphcsr::~graphcsr() {
+    delete[] offsets;
+    delete[] targets;
+    delete[] weights;
+}
+
 graph::graph(int num) {
     V = num;
+    cap = num;
+    livecount = num;
     array = new singlenode*[V];
     for (int i = 0; i < V; i++) array[i] = 0;
+    inarray = 0;
+    stableids = false;
+    alive = 0;
+    freeids = 0;
+    freecount = 0;
+    spt = 0;
+    coords = 0;
+    frozen = false;
+    csr = 0;
+    rcsr = 0;
 }
 
 graph::~graph() {
+    delete[] array;
+    delete[] inarray;
+    delete[] alive;
+    delete[] freeids;
+    delete csr;
+    delete rcsr;
+    delete spt;
+    delete[] coords;
+}
+
+singlenode* graph::newnode(int v, double w) {
+    return pool.alloc(v, w);
+}
+
+singlenode* graph::allocblock(int n) {
+    return pool.allocrun(n);
+}
+
+void graph::freenode(singlenode* n) {
+    pool.release(n);
+}
+
+void graph::clearEdges() {
+    invalidate();
     for (int i = 0; i < V; i++) {
-        singlenode* t = array[i];
-        while (t) {
-            singlenode* x = t;
-            t = t->nextnode;
-            delete x;
+        array[i] = 0;
+        if (inarray) inarray[i] = 0;
+    }
+    pool.clear();
+    if (spt) spt->recomputeall();
+}
+
+void graph::getAllocStats(double* out) {
+    out[0] = (double)pool.allocs;
+    out[1] = (double)pool.frees;
+    out[2] = (double)(pool.allocs - pool.frees);
+    out[3] = (double)pool.slabcount;
+}
+
+// Unlinks and frees the first node for vertex v in the list at head,
+// reporting its weight through outWeight when asked.
+int graph::unlinkall(singlenode*& head, int v) {
+    int removed = 0;
+    singlenode** link = &head;
+    while (*link) {
+        singlenode* curr = *link;
+        if (curr->vertex == v) {
+            *link = curr->nextnode;
+            freenode(curr);
+            removed++;
+        } else {
+            link = &curr->nextnode;
         }
     }
-    delete[] array;
+    return removed;
 }
 
-void graph::addnode() {
-    singlenode** newarr = new singlenode*[V + 1];
-    for (int i = 0; i < V; i++) newarr[i] = array[i];
-    newarr[V] = 0;
-    delete[] array;
-    array = newarr;
-    V++;
+bool graph::unlinkfirst(singlenode*& head, int v, double* outWeight) {
+    singlenode* prev = 0;
+    singlenode* curr = head;
+
+    while (curr) {
+        if (curr->vertex == v) {
+            if (prev == 0) head = curr->nextnode;
+            else prev->nextnode = curr->nextnode;
+            if (outWeight) *outWeight = curr->weight;
+            freenode(curr);
+            return true;
+        }
+        prev = curr;
+        curr = curr->nextnode;
+    }
+    return false;
 }
 
-void graph::removeAllEdgesFrom(int u) {
-    singlenode* t = array[u];
+// Like unlinkfirst, but only a node carrying weight w matches. Keeps the
+// reverse index in step when parallel edges have different weights.
+bool graph::unlinkexact(singlenode*& head, int v, double w) {
+    singlenode* prev = 0;
+    singlenode* curr = head;
+
+    while (curr) {
+        if (curr->vertex == v && curr->weight == w) {
+            if (prev == 0) head = curr->nextnode;
+            else prev->nextnode = curr->nextnode;
+            freenode(curr);
+            return true;
+        }
+        prev = curr;
+        curr = curr->nextnode;
+    }
+    return false;
+}
+
+void graph::freelist(singlenode*& head) {
+    singlenode* t = head;
     while (t) {
         singlenode* x = t;
         t = t->nextnode;
-        delete x;
+        freenode(x);
+    }
+    head = 0;
+}
+
+void graph::invalidate() {
+    delete csr;
+    delete rcsr;
+    csr = 0;
+    rcsr = 0;
+}
+
+graphcsr* graph::buildcsr(bool transpose) {
+    int E = 0;
+    int* degree = new int[V + 1];
+    for (int i = 0; i <= V; i++) degree[i] = 0;
+    for (int i = 0; i < V; i++)
+        for (singlenode* t = array[i]; t; t = t->nextnode) {
+            degree[transpose ? t->vertex : i]++;
+            E++;
+        }
+
+    graphcsr* c = new graphcsr(V, E);
+    int e = 0;
+    for (int i = 0; i < V; i++) {
+        c->offsets[i] = e;
+        e += degree[i];
+    }
+    c->offsets[V] = e;
+
+    // degree[] becomes the fill cursor of each row.
+    for (int i = 0; i < V; i++) degree[i] = c->offsets[i];
+    for (int i = 0; i < V; i++)
+        for (singlenode* t = array[i]; t; t = t->nextnode) {
+            int row = transpose ? t->vertex : i;
+            int at = degree[row]++;
+            c->targets[at] = transpose ? i : t->vertex;
+            c->weights[at] = t->weight;
+        }
+    delete[] degree;
+    return c;
+}
+
+graphcsr* graph::snapshot() {
+    if (!frozen) return 0;
+    if (!csr) csr = buildcsr(false);
+    return csr;
+}
+
+graphcsr* graph::transposed() {
+    if (!frozen) return 0;
+    if (!rcsr) rcsr = buildcsr(true);
+    return rcsr;
+}
+
+void graph::freeze() {
+    frozen = true;
+    snapshot();
+}
+
+void graph::unfreeze() {
+    frozen = false;
+    invalidate();
+}
+
+bool graph::isFrozen() {
+    return frozen;
+}
+
+bool graph::valid(int u) {
+    if (u < 0 || u >= V) return false;
+    return !alive || alive[u];
+}
+
+void graph::grow(int need) {
+    if (need <= cap) return;
+    int c = cap ? cap : 4;
+    while (c < need) c *= 2;
+
+    singlenode** newarr = new singlenode*[c];
+    for (int i = 0; i < V; i++) newarr[i] = array[i];
+    delete[] array;
+    array = newarr;
+
+    if (inarray) {
+        singlenode** newin = new singlenode*[c];
+        for (int i = 0; i < V; i++) newin[i] = inarray[i];
+        delete[] inarray;
+        inarray = newin;
+    }
+    if (alive) {
+        bool* newalive = new bool[c];
+        for (int i = 0; i < V; i++) newalive[i] = alive[i];
+        delete[] alive;
+        alive = newalive;
+
+        int* newfree = new int[c];
+        for (int i = 0; i < freecount; i++) newfree[i] = freeids[i];
+        delete[] freeids;
+        freeids = newfree;
+    }
+    if (coords) {
+        double* newcoords = new double[2 * c];
+        for (int i = 0; i < 2 * V; i++) newcoords[i] = coords[i];
+        delete[] coords;
+        coords = newcoords;
     }
-    array[u] = 0;
+    cap = c;
+}
+
+int graph::addnode() {
+    invalidate();
+    if (freecount > 0) {
+        int u = freeids[--freecount];
+        alive[u] = true;
+        livecount++;
+        if (coords) coords[2 * u] = coords[2 * u + 1] = 0;
+        if (spt) spt->vertexadded(u);
+        return u;
+    }
+
+    grow(V + 1);
+    array[V] = 0;
+    if (inarray) inarray[V] = 0;
+    if (alive) alive[V] = true;
+    if (coords) coords[2 * V] = coords[2 * V + 1] = 0;
+    livecount++;
+    if (spt) spt->vertexadded(V);
+    return V++;
+}
+
+void graph::removeAllEdgesFrom(int u) {
+    freelist(array[u]);
 }
 
 void graph::removenode(int u) {
-    if (u < 0 || u >= V) return;
+    if (!valid(u)) return;
+
+    invalidate();
+
+    if (stableids) {
+        if (spt) spt->vertexremoving(u);
+        // Only u's neighbours are touched: out-edges are unlinked from the
+        // targets' reverse lists, in-edges from the sources' lists.
+        for (singlenode* t = array[u]; t; t = t->nextnode)
+            if (t->vertex != u) unlinkfirst(inarray[t->vertex], u);
+        for (singlenode* t = inarray[u]; t; t = t->nextnode)
+            if (t->vertex != u) unlinkfirst(array[t->vertex], u);
+        removeAllEdgesFrom(u);
+        freelist(inarray[u]);
+
+        alive[u] = false;
+        freeids[freecount++] = u;
+        livecount--;
+        if (spt) spt->vertexremoved(u);
+        return;
+    }
 
     removeAllEdgesFrom(u);
 
+    // Parallel edges are allowed, so every i -> u edge has to go; a
+    // leftover would point at id V once the ids above u shift down.
     for (int i = 0; i < V; i++) {
         if (i == u) continue;
-
-        singlenode* prev = 0;
-        singlenode* curr = array[i];
-
-        while (curr) {
-            if (curr->vertex == u) {
-                if (prev == 0) array[i] = curr->nextnode;
-                else prev->nextnode = curr->nextnode;
-                delete curr;
-                break;
-            }
-            prev = curr;
-            curr = curr->nextnode;
-        }
+        unlinkall(array[i], u);
     }
 
     for (int i = 0; i < V; i++) {
@@ -75,24 +442,113 @@ void graph::removenode(int u) {
         }
     }
 
-    singlenode** newarr = new singlenode*[V - 1];
-    int idx = 0;
+    for (int i = u; i < V - 1; i++) array[i] = array[i + 1];
+    if (coords)
+        for (int i = 2 * u; i < 2 * (V - 1); i++) coords[i] = coords[i + 2];
+    // buildreverse only frees the lists below the new V.
+    if (inarray) freelist(inarray[V - 1]);
+    V--;
+    livecount--;
+    if (inarray) buildreverse();
+    if (spt) {
+        int* remap = new int[V + 1];
+        for (int i = 0; i <= V; i++) remap[i] = i < u ? i : i == u ? -1 : i - 1;
+        spt->relabel(remap);
+        delete[] remap;
+    }
+}
+
+void graph::buildreverse() {
+    if (inarray)
+        for (int i = 0; i < V; i++) freelist(inarray[i]);
+    delete[] inarray;
+
+    inarray = new singlenode*[cap];
+    for (int i = 0; i < V; i++) inarray[i] = 0;
+    for (int i = 0; i < V; i++)
+        for (singlenode* t = array[i]; t; t = t->nextnode) {
+            singlenode* r = newnode(i, t->weight);
+            r->nextnode = inarray[t->vertex];
+            inarray[t->vertex] = r;
+        }
+}
+
+void graph::enableReverseIndex() {
+    if (!inarray) buildreverse();
+}
+
+void graph::setStableIds(bool on) {
+    if (on == stableids) return;
+
+    if (on) {
+        stableids = true;
+        alive = new bool[cap];
+        for (int i = 0; i < V; i++) alive[i] = true;
+        freeids = new int[cap];
+        freecount = 0;
+        enableReverseIndex();
+        return;
+    }
+
+    compact();
+    stableids = false;
+    delete[] alive;
+    delete[] freeids;
+    alive = 0;
+    freeids = 0;
+    freecount = 0;
+}
+
+void graph::compact() {
+    if (!alive || freecount == 0) return;
+
+    invalidate();
+    int* remap = new int[V];
+    int n = 0;
+    for (int i = 0; i < V; i++) remap[i] = alive[i] ? n++ : -1;
+
     for (int i = 0; i < V; i++) {
-        if (i == u) continue;
-        newarr[idx++] = array[i];
+        if (!alive[i]) continue;
+        for (singlenode* t = array[i]; t; t = t->nextnode) t->vertex = remap[t->vertex];
+        array[remap[i]] = array[i];
+        if (inarray) {
+            for (singlenode* t = inarray[i]; t; t = t->nextnode) t->vertex = remap[t->vertex];
+            inarray[remap[i]] = inarray[i];
+        }
+        alive[remap[i]] = true;
+        if (coords) {
+            coords[2 * remap[i]] = coords[2 * i];
+            coords[2 * remap[i] + 1] = coords[2 * i + 1];
+        }
     }
+    V = n;
+    freecount = 0;
+    if (spt) spt->relabel(remap);
+    delete[] remap;
+}
 
-    delete[] array;
-    array = newarr;
-    V--;
+bool graph::isAlive(int u) {
+    return valid(u);
+}
+
+int graph::getLiveCount() {
+    return livecount;
 }
 
 void graph::addedge(int u, int v, double weight) {
-    if (u < 0 || v < 0 || u >= V || v >= V) return;
+    if (!valid(u) || !valid(v)) return;
 
-    singlenode* n = new singlenode(v, weight);
+    invalidate();
+    singlenode* n = newnode(v, weight);
     n->nextnode = array[u];
     array[u] = n;
+
+    if (inarray) {
+        singlenode* r = newnode(u, weight);
+        r->nextnode = inarray[v];
+        inarray[v] = r;
+    }
+    if (spt) spt->edgeadded(u, v, weight);
 }
 
 void graph::addendirectededge(int u, int v, double weight) {
@@ -101,21 +557,36 @@ void graph::addendirectededge(int u, int v, double weight) {
 }
 
 void graph::removeedge(int u, int v) {
-    if (u < 0 || v < 0 || u >= V || v >= V) return;
+    if (!valid(u) || !valid(v)) return;
 
-    singlenode* prev = 0;
-    singlenode* curr = array[u];
+    double w;
+    if (!unlinkfirst(array[u], v, &w)) return;
+    invalidate();
+    if (inarray) unlinkexact(inarray[v], u, w);
+    if (spt) spt->edgeremoved(u, v);
+}
 
-    while (curr) {
-        if (curr->vertex == v) {
-            if (prev == 0) array[u] = curr->nextnode;
-            else prev->nextnode = curr->nextnode;
-            delete curr;
-            return;
-        }
-        prev = curr;
-        curr = curr->nextnode;
-    }
+void graph::trackSource(int source) {
+    if (!valid(source)) return;
+    enableReverseIndex();
+    if (!spt) spt = new sptcache(this);
+    spt->track(source);
+}
+
+void graph::untrackSource(int source) {
+    if (spt) spt->untrack(source);
+}
+
+double graph::cachedDist(int source, int v) {
+    spttree* t = spt ? spt->find(source) : 0;
+    if (!t || v < 0 || v >= V) return INF;
+    return t->dist[v];
+}
+
+int graph::cachedParent(int source, int v) {
+    spttree* t = spt ? spt->find(source) : 0;
+    if (!t || v < 0 || v >= V) return -1;
+    return t->parent[v];
 }
 
 void graph::printgraph() {
@@ -135,7 +606,7 @@ int graph::getVertexCount() {
 }
 
 int* graph::BFS(int start, int& outCount) {
-    if (start < 0 || start >= V) {
+    if (!valid(start)) {
         outCount = 0;
         return 0;
     }
@@ -149,6 +620,7 @@ int* graph::BFS(int start, int& outCount) {
     int* q = new int[V];
     int front = 0, rear = 0;
 
+    snapshot();
     visited[start] = true;
     q[rear++] = start;
 
@@ -156,15 +628,12 @@ int* graph::BFS(int start, int& outCount) {
         int u = q[front++];
         order[idx++] = u;
 
-        singlenode* t = array[u];
-        while (t) {
-            int v = t->vertex;
+        forEachEdge(u, [&](int v, double) {
             if (!visited[v]) {
                 visited[v] = true;
                 q[rear++] = v;
             }
-            t = t->nextnode;
-        }
+        });
     }
     delete[] visited;
     delete[] q;
@@ -173,7 +642,7 @@ int* graph::BFS(int start, int& outCount) {
 }
 
 int* graph::DFS(int start, int& outCount) {
-    if (start < 0 || start >= V) {
+    if (!valid(start)) {
         outCount = 0;
         return 0;
     }
@@ -181,7 +650,14 @@ int* graph::DFS(int start, int& outCount) {
     for (int i = 0; i < V; i++) visited[i] = false;
     int* order = new int[V];
     int idx = 0;
-    int* stack = new int[V];
+    // Every edge out of a vertex can be pushed once, so the stack needs
+    // E + 1 slots, not V.
+    int E = 0;
+    if (snapshot()) E = csr->E;
+    else
+        for (int i = 0; i < V; i++)
+            for (singlenode* t = array[i]; t; t = t->nextnode) E++;
+    int* stack = new int[E + 1];
     int top = -1;
     stack[++top] = start;
     while (top >= 0) {
@@ -189,12 +665,9 @@ int* graph::DFS(int start, int& outCount) {
         if (!visited[u]) {
             visited[u] = true;
             order[idx++] = u;
-            singlenode* t = array[u];
-            while (t) {
-                int v = t->vertex;
+            forEachEdge(u, [&](int v, double) {
                 if (!visited[v]) stack[++top] = v;
-                t = t->nextnode;
-            }
+            });
         }
     }
     delete[] visited;
@@ -203,122 +676,122 @@ int* graph::DFS(int start, int& outCount) {
     return order;
 }
 
-void graph::swapval(int& a, int& b) {
-    int t = a;
-    a = b;
-    b = t;
-}
+// Lazy insertion: a vertex enters the queue when first reached, so
+// unreachable ones never cost a push or a pop.
+template <class PQ>
+void graph::dijkstrawith(PQ& q, int start, double* outDist, int* outParent) {
+    if (!valid(start)) return;
 
-void graph::heapifydown(int heap[], double key[], int pos[], int size, int i) {
-    int left = 2 * i;
-    int right = 2 * i + 1;
-    int smallest = i;
-    if (left <= size && key[heap[left]] < key[heap[smallest]])
-        smallest = left;
-    if (right <= size && key[heap[right]] < key[heap[smallest]])
-        smallest = right;
-    if (smallest != i) {
-        pos[heap[i]] = smallest;
-        pos[heap[smallest]] = i;
-        swapval(heap[i], heap[smallest]);
-        heapifydown(heap, key, pos, size, smallest);
+    double* dist = outDist;
+    int* parent = outParent;
+    scratch.reserve(V);
+    bool* visited = scratch.visited;
+    for (int i = 0; i < V; i++) {
+        dist[i] = INF;
+        parent[i] = -1;
+        visited[i] = false;
     }
-}
-
-int graph::extractmin(int heap[], double key[], int pos[], int& size) {
-    int root = heap[1];
-    int last = heap[size];
-    heap[1] = last;
-    pos[last] = 1;
-    size--;
-    heapifydown(heap, key, pos, size, 1);
-    return root;
-}
-
-void graph::decreasekey(int heap[], double key[], int pos[], int v) {
-    int i = pos[v];
-    while (i > 1 && key[heap[i]] < key[heap[i / 2]]) {
-        pos[heap[i]] = i / 2;
-        pos[heap[i / 2]] = i;
-        swapval(heap[i], heap[i / 2]);
-        i = i / 2;
+    q.reset(V);
+    dist[start] = 0;
+    q.push(start, 0);
+    snapshot();
+    while (!q.empty()) {
+        int u = q.pop();
+        visited[u] = true;
+        forEachEdge(u, [&](int v, double w) {
+            if (visited[v] || !(dist[u] + w < dist[v])) return;
+            bool queued = dist[v] != INF;
+            dist[v] = dist[u] + w;
+            parent[v] = u;
+            if (queued) q.decrease(v, dist[v]);
+            else q.push(v, dist[v]);
+        });
     }
 }
 
-void graph::dijkstra(int start) {
-    double inf = 1e9;
-    double dist[1000];
-    int parent[1000];
-    bool visited[1000];
-    int heap[1000];
-    int pos[1000];
-    int heapsize = V;
+// Grows a tree from vertex 0, then from the lowest unvisited vertex of
+// each remaining component, so the result is a spanning forest.
+template <class PQ>
+int graph::primwith(PQ& q, int* outEdges, double* outWeights) {
+    if (V == 0) return 0;
+
+    scratch.reserve(V);
+    double* key = scratch.key;
+    bool* visited = scratch.visited;
+    int* parent = scratch.parent;
     for (int i = 0; i < V; i++) {
-        dist[i] = inf;
-        parent[i] = -1;
         visited[i] = false;
-        heap[i + 1] = i;
-        pos[i] = i + 1;
+        key[i] = INF;
+        parent[i] = -1;
     }
-    dist[start] = 0;
-    decreasekey(heap, dist, pos, start);
-    while (heapsize > 0) {
-        int u = extractmin(heap, dist, pos, heapsize);
-        visited[u] = true;
-        singlenode* t = array[u];
-        while (t) {
-            int v = t->vertex;
-            double w = t->weight;
-            if (!visited[v] && dist[u] + w < dist[v]) {
-                dist[v] = dist[u] + w;
+    q.reset(V);
+    snapshot();
+    for (int root = 0; root < V; root++) {
+        if (visited[root]) continue;
+        key[root] = 0;
+        q.push(root, 0);
+        while (!q.empty()) {
+            int u = q.pop();
+            visited[u] = true;
+            forEachEdge(u, [&](int v, double w) {
+                if (visited[v] || !(w < key[v])) return;
+                bool queued = key[v] != INF;
+                key[v] = w;
                 parent[v] = u;
-                decreasekey(heap, dist, pos, v);
-            }
-            t = t->nextnode;
+                if (queued) q.decrease(v, w);
+                else q.push(v, w);
+            });
         }
     }
+
+    int count = 0;
+    for (int i = 0; i < V; i++) {
+        if (parent[i] < 0) continue;
+        outEdges[2 * count] = parent[i];
+        outEdges[2 * count + 1] = i;
+        outWeights[count] = key[i];
+        count++;
+    }
+    return count;
+}
+
+template void graph::dijkstrawith(daryipq<4>&, int, double*, int*);
+template void graph::dijkstrawith(pairingipq&, int, double*, int*);
+template void graph::dijkstrawith(radixipq&, int, double*, int*);
+template int graph::primwith(daryipq<4>&, int*, double*);
+template int graph::primwith(pairingipq&, int*, double*);
+
+void graph::dijkstra(int start, double* outDist, int* outParent) {
+    dijkstrawith(scratch.dijkstraq, start, outDist, outParent);
+}
+
+int graph::prim(int* outEdges, double* outWeights) {
+    return primwith(scratch.primq, outEdges, outWeights);
+}
+
+void graph::dijkstra(int start) {
+    if (!valid(start)) return;
+    double* dist = new double[V];
+    int* parent = new int[V];
+    dijkstra(start, dist, parent);
     cout << "\nDijkstra Shortest Paths from " << start << ":\n";
     for (int i = 0; i < V; i++) {
         cout << "Vertex " << i << ": dist=" << dist[i]
              << ", parent=" << parent[i] << endl;
     }
+    delete[] dist;
+    delete[] parent;
 }
 
 void graph::prim() {
-    int start = 0;
-    double inf = 1e9;
-    double key[1000];
-    bool visited[1000];
-    int parent[1000];
-    int heap[1000];
-    int pos[1000];
-    int heapsize = V;
-    for (int i = 0; i < V; i++) {
-        visited[i] = false;
-        key[i] = inf;
-        parent[i] = -1;
-        pos[i] = i + 1;
-        heap[i + 1] = i;
-    }
-    key[start] = 0;
-    decreasekey(heap, key, pos, start);
-    while (heapsize > 0) {
-        int u = extractmin(heap, key, pos, heapsize);
-        visited[u] = true;
-        singlenode* t = array[u];
-        while (t) {
-            int v = t->vertex;
-            double w = t->weight;
-            if (!visited[v] && w < key[v]) {
-                key[v] = w;
-                parent[v] = u;
-                decreasekey(heap, key, pos, v);
-            }
-            t = t->nextnode;
-        }
-    }
+    int* edges = new int[2 * V];
+    double* weights = new double[V];
+    int count = prim(edges, weights);
     cout << "\nPRIM'S MST (starting at 0):\n";
-    for (int i = 1; i < V; i++) {
-        cout << parent[i] << " -- " << i << "   weight=" << key[i] << endl;
+    for (int i = 0; i < count; i++) {
+        cout << edges[2 * i] << " -- " << edges[2 * i + 1]
+             << "   weight=" << weights[i] << endl;
     }
+    delete[] edges;
+    delete[] weights;
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include <iostream>
+#include "graphspt.h"
+#include "indexedpq.h"
 
 class singlenode {
 public:
@@ -9,33 +11,264 @@ public:
     singlenode(int val, double w);
 };
 
+// Per-graph allocator for edge nodes. Nodes are carved from slabs by
+// bumping a cursor, and freed nodes go on a free list (linked through
+// nextnode) for reuse, so steady-state edge churn never reaches malloc.
+// Slabs double in size up to SLABMAX nodes; dropping the pool frees whole
+// slabs, never single nodes.
+class edgepool {
+public:
+    struct slab {
+        singlenode* nodes;
+        slab* next;
+    };
+
+    slab* slabs;
+    singlenode* cursor;
+    singlenode* end;
+    singlenode* freehead;
+    int nextslab;
+
+    long long allocs;     // nodes handed out
+    long long frees;      // nodes returned
+    long long slabcount;  // underlying heap allocations
+
+    edgepool();
+    ~edgepool();
+
+    singlenode* alloc(int v, double w);
+    void release(singlenode* n);
+    // n contiguous nodes in a slab of their own, for bulk loaders.
+    singlenode* allocrun(int n);
+    void clear();
+
+private:
+    singlenode* newslab(int n);
+};
+
+// Immutable compressed-sparse-row view of the adjacency lists.
+// Edges of vertex u live in [offsets[u], offsets[u + 1]) of targets/weights,
+// in the same order as the linked list they were built from.
+class graphcsr {
+public:
+    int V;
+    int E;
+    int* offsets;
+    int* targets;
+    double* weights;
+
+    graphcsr(int v, int e);
+    ~graphcsr();
+};
+
+// Work arrays and queues shared by dijkstra/prim. They only grow, so
+// repeated queries on the same graph do not reallocate. Point-to-point
+// queries also use the second key/parent pair and treat an entry as set
+// only when its seen[] value equals stamp, so they never clear O(V) state.
+class graphscratch {
+public:
+    int cap;
+    double* key;
+    int* parent;
+    bool* visited;
+    double* key2;
+    int* parent2;
+    int* seen;
+    int* seen2;
+    int stamp;
+    dijkstrapq dijkstraq;
+    primpq primq;
+
+    graphscratch();
+    ~graphscratch();
+    void reserve(int n);
+    int nextstamp();
+};
+
+enum reordermode {
+    REORDER_DEGREE,  // by undirected degree, highest first
+    REORDER_BFS,     // breadth-first discovery order
+    REORDER_RCM      // reverse Cuthill-McKee
+};
+
 class graph {
 public:
     int V;
+    int cap;
+    int livecount;
     singlenode** array;
+    // In-edge lists (vertex = source), kept only once enableReverseIndex
+    // or stable ids switched them on.
+    singlenode** inarray;
+    // Stable-id mode: removed vertices become tombstones and their slots
+    // are recycled through freeids instead of renumbering everyone above.
+    bool stableids;
+    bool* alive;
+    int* freeids;
+    int freecount;
+    edgepool pool;
+    bool frozen;
+    graphcsr* csr;
+    graphcsr* rcsr;
+    graphscratch scratch;
+    sptcache* spt;
+    // Optional (x, y) per vertex for A*; null until setCoordinates.
+    double* coords;
+    singlenode* newnode(int v, double w);
+    void freenode(singlenode* n);
+    bool unlinkfirst(singlenode*& head, int v, double* outWeight = 0);
+    // Unlinks and frees every node for v; returns how many.
+    int unlinkall(singlenode*& head, int v);
+    bool unlinkexact(singlenode*& head, int v, double w);
+    void freelist(singlenode*& head);
     void removeAllEdgesFrom(int u);
+    bool valid(int u);
+    void grow(int need);
+    void buildreverse();
+    void invalidate();
+    graphcsr* buildcsr(bool transpose);
+    graphcsr* snapshot();
+    graphcsr* transposed();
+
+    // Visits every edge (v, w) leaving u, from the CSR view when one is live.
+    template <class Fn>
+    void forEachEdge(int u, Fn fn) {
+        if (csr) {
+            int end = csr->offsets[u + 1];
+            for (int e = csr->offsets[u]; e < end; e++)
+                fn(csr->targets[e], csr->weights[e]);
+            return;
+        }
+        for (singlenode* t = array[u]; t; t = t->nextnode)
+            fn(t->vertex, t->weight);
+    }
+
+    // Visits every edge (u, w) entering v. Needs the transposed snapshot
+    // or the reverse index.
+    template <class Fn>
+    void forEachInEdge(int v, Fn fn) {
+        if (rcsr) {
+            int end = rcsr->offsets[v + 1];
+            for (int e = rcsr->offsets[v]; e < end; e++)
+                fn(rcsr->targets[e], rcsr->weights[e]);
+            return;
+        }
+        for (singlenode* t = inarray[v]; t; t = t->nextnode)
+            fn(t->vertex, t->weight);
+    }
+
+    int tracepath(int meet, int t, int* outPath, int cap);
 
 public:
     graph(int num);
     ~graph();
 
-    void addnode();
+    // Hands out n contiguous edge nodes owned by the graph, for loaders
+    // that wire adjacency lists themselves.
+    singlenode* allocblock(int n);
+    // Drops every edge (and the reverse index) in O(slabs).
+    void clearEdges();
+    // out[0..3] = nodes allocated, nodes freed, nodes live, slabs.
+    void getAllocStats(double* out);
+
+    // Returns the new vertex id (a recycled slot in stable-id mode).
+    int addnode();
     void removenode(int u);
 
+    // With stable ids on, removenode is O(degree) and leaves a tombstone;
+    // ids of other vertices never change. Switching it off compacts the
+    // tombstones away, renumbering the survivors densely.
+    void setStableIds(bool on);
+    void compact();
+    void enableReverseIndex();
+    bool isAlive(int u);
+    int getLiveCount();
+
+    // Keeps a shortest-path tree from source up to date across mutations
+    // (see sptcache), so cachedDist/cachedParent answer in O(1) without
+    // rerunning dijkstra. Switches the reverse index on.
+    void trackSource(int source);
+    void untrackSource(int source);
+    double cachedDist(int source, int v);
+    int cachedParent(int source, int v);
+
     void addedge(int u, int v, double weight);
     void addendirectededge(int u, int v, double weight);
     void removeedge(int u, int v);
 
+    // Freeze builds a CSR snapshot that BFS/DFS/dijkstra/prim traverse
+    // instead of the lists. Mutations drop the snapshot; while frozen it is
+    // rebuilt lazily by the next traversal.
+    void freeze();
+    void unfreeze();
+    bool isFrozen();
+
     void printgraph();
     int getVertexCount();
 
     int* BFS(int start, int& outCount);
+    // Direction-optimizing BFS over a bitmap frontier: top-down while the
+    // frontier is small, bottom-up over in-edges once it covers a large
+    // share of the edges. Runs on threadpool::shared(). Returns vertices in
+    // level order like BFS; outLevels (optional, V entries) gets each
+    // vertex's depth or -1.
+    int* BFSDirectionOptimizing(int start, int& outCount, int* outLevels = 0);
     int* DFS(int start, int& outCount);
 
-    void swapval(int& a, int& b);
-    void heapifydown(int heap[], double key[], int pos[], int size, int i);
-    int extractmin(int heap[], double key[], int pos[], int& size);
-    void decreasekey(int heap[], double key[], int pos[], int v);
+    // outDist/outParent receive V entries; unreachable vertices get
+    // dist = inf and parent = -1.
+    void dijkstra(int start, double* outDist, int* outParent);
+    // Writes (parent, child) pairs to outEdges and their weights to
+    // outWeights (room for V - 1 edges); returns the number of edges.
+    int prim(int* outEdges, double* outWeights);
+    // The same over a caller-chosen queue from indexedpq.h; dijkstra and
+    // prim use the one picked by DS_GRAPH_PQ. Instantiated for
+    // daryipq<4>, pairingipq and (dijkstra only) radixipq.
+    template <class PQ>
+    void dijkstrawith(PQ& q, int start, double* outDist, int* outParent);
+    template <class PQ>
+    int primwith(PQ& q, int* outEdges, double* outWeights);
+
+    // Relabels vertices so neighbours get nearby ids, which turns the
+    // visited/dist accesses of traversals into near-sequential ones.
+    // outNewId[old] and outOldId[new] (V entries each, either may be null)
+    // translate between the two numberings. Tombstones move to the end.
+    void reorder(int mode, int* outNewId, int* outOldId);
+    // Renames vertex i to perm[i]; perm must be a permutation of [0, V).
+    void permute(const int* perm);
+
+    // Point-to-point queries that stop as soon as t is settled. Both
+    // return the s -> t distance (inf when unreachable) and write the path
+    // s..t to outPath if it fits in cap entries; outLen gets its length.
+    // shortestPath runs Dijkstra from both ends at once over the reverse
+    // index (switched on if needed) and stops when the two frontiers'
+    // minimum keys add up to the best meeting distance.
+    double shortestPath(int s, int t, int* outPath, int cap, int& outLen);
+    // A* with a caller heuristic h(v, t, ctx), which must never
+    // overestimate the remaining distance.
+    typedef double (*heuristicfn)(int v, int t, void* ctx);
+    double astar(int s, int t, heuristicfn h, void* ctx, int* outPath, int cap, int& outLen);
+    // A* with scale * straight-line distance between vertex coordinates.
+    double astarEuclidean(int s, int t, double scale, int* outPath, int cap, int& outLen);
+    // xy holds n (x, y) pairs for vertices 0..n-1; the rest get (0, 0).
+    void setCoordinates(const double* xy, int n);
+
+    // Minimum spanning forest, treating every edge as undirected. Same
+    // output contract as prim, but every component gets its tree, so the
+    // buffers need room for V - 1 edges. boruvka runs its rounds over a
+    // union-find with the per-component cheapest-edge search spread over
+    // threadpool::shared(); kruskal sorts the edges with a parallel merge
+    // sort and then scans them once.
+    int boruvka(int* outEdges, double* outWeights);
+    int kruskal(int* outEdges, double* outWeights);
+
+    // Delta-stepping SSSP (Meyer & Sanders) over threadpool::shared():
+    // vertices are bucketed by floor(dist / delta), light edges (w <= delta)
+    // are relaxed until the current bucket drains, heavy edges once per
+    // settled vertex. Distances match dijkstra; parents may differ on ties.
+    // delta <= 0 picks max weight / average degree; smaller deltas than
+    // max weight / 65534 are raised to that so the bucket ring stays bounded.
+    void deltastepping(int start, double delta, double* outDist, int* outParent);
 
     void dijkstra(int start);
     void prim();
@@ -0,0 +1,134 @@
+#include "graph.h"
+#include "threadpool.h"
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+// Switching thresholds from Beamer et al.: go bottom-up once the frontier
+// owns more than 1/ALPHA of the unexplored edges, and back to top-down once
+// it shrinks below V/BETA vertices.
+static const int ALPHA = 15;
+static const int BETA = 18;
+
+int* graph::BFSDirectionOptimizing(int start, int& outCount, int* outLevels) {
+    if (!valid(start)) {
+        outCount = 0;
+        return 0;
+    }
+
+    // Bottom-up steps scan in-edges, so both directions are needed as CSR.
+    // Frozen graphs keep theirs; otherwise build throwaway copies.
+    graphcsr* out = snapshot();
+    graphcsr* in = transposed();
+    bool owned = out == 0;
+    if (owned) {
+        out = buildcsr(false);
+        in = buildcsr(true);
+    }
+
+    threadpool& pool = threadpool::shared();
+    int T = pool.size();
+
+    std::atomic<int>* level = new std::atomic<int>[V];
+    for (int i = 0; i < V; i++) level[i].store(-1, std::memory_order_relaxed);
+
+    int words = (V + 63) / 64;
+    uint64_t* front = new uint64_t[words];
+    std::vector<std::vector<int> > local(T);
+    std::vector<long long> localedges(T);
+
+    // order doubles as the queue: the current frontier is
+    // order[frontbegin, frontend).
+    int* order = new int[V];
+    int count = 0;
+    level[start].store(0, std::memory_order_relaxed);
+    order[count++] = start;
+    int frontbegin = 0, frontend = 1;
+
+    long long frontieredges = out->offsets[start + 1] - out->offsets[start];
+    long long unexplorededges = out->E - frontieredges;
+    bool bottomup = false;
+    int depth = 0;
+
+    while (frontend > frontbegin) {
+        int nf = frontend - frontbegin;
+        if (!bottomup && frontieredges > unexplorededges / ALPHA)
+            bottomup = true;
+        else if (bottomup && nf < V / BETA)
+            bottomup = false;
+
+        for (int t = 0; t < T; t++) {
+            local[t].clear();
+            localedges[t] = 0;
+        }
+        int nextdepth = depth + 1;
+
+        if (!bottomup) {
+            pool.parallelfor(nf, 64, [&](int b, int e, int tid) {
+                std::vector<int>& mine = local[tid];
+                long long edges = 0;
+                for (int i = b; i < e; i++) {
+                    int u = order[frontbegin + i];
+                    for (int k = out->offsets[u]; k < out->offsets[u + 1]; k++) {
+                        int v = out->targets[k];
+                        int expect = -1;
+                        if (level[v].load(std::memory_order_relaxed) == -1 &&
+                            level[v].compare_exchange_strong(expect, nextdepth,
+                                                             std::memory_order_relaxed)) {
+                            mine.push_back(v);
+                            edges += out->offsets[v + 1] - out->offsets[v];
+                        }
+                    }
+                }
+                localedges[tid] += edges;
+            });
+        } else {
+            for (int w = 0; w < words; w++) front[w] = 0;
+            for (int i = frontbegin; i < frontend; i++)
+                front[order[i] >> 6] |= (uint64_t)1 << (order[i] & 63);
+
+            // Chunks are whole bitmap words, so each vertex is owned by
+            // exactly one thread and needs no CAS.
+            pool.parallelfor(words, 16, [&](int b, int e, int tid) {
+                std::vector<int>& mine = local[tid];
+                long long edges = 0;
+                int vend = e * 64 < V ? e * 64 : V;
+                for (int v = b * 64; v < vend; v++) {
+                    if (level[v].load(std::memory_order_relaxed) != -1) continue;
+                    for (int k = in->offsets[v]; k < in->offsets[v + 1]; k++) {
+                        int u = in->targets[k];
+                        if (front[u >> 6] & ((uint64_t)1 << (u & 63))) {
+                            level[v].store(nextdepth, std::memory_order_relaxed);
+                            mine.push_back(v);
+                            edges += out->offsets[v + 1] - out->offsets[v];
+                            break;
+                        }
+                    }
+                }
+                localedges[tid] += edges;
+            });
+        }
+
+        frontbegin = frontend;
+        frontieredges = 0;
+        for (int t = 0; t < T; t++) {
+            for (size_t i = 0; i < local[t].size(); i++) order[count++] = local[t][i];
+            frontieredges += localedges[t];
+        }
+        frontend = count;
+        unexplorededges -= frontieredges;
+        depth = nextdepth;
+    }
+
+    if (outLevels)
+        for (int i = 0; i < V; i++) outLevels[i] = level[i].load(std::memory_order_relaxed);
+
+    delete[] level;
+    delete[] front;
+    if (owned) {
+        delete out;
+        delete in;
+    }
+    outCount = count;
+    return order;
+}
@@ -0,0 +1,282 @@
+#include "graphloader.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined(_WIN32)
+#include <stdio.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Edges parsed from text, plus the out-degree of every vertex seen so far.
+struct edgebuffer {
+    std::vector<int> src;
+    std::vector<int> dst;
+    std::vector<double> w;
+    std::vector<int> degree;
+};
+
+// Lays out the edges so each vertex owns a contiguous run of one block.
+// The k-th edge of u in input order lands at the end of u's run minus k,
+// which reproduces the head-insertion order of addedge. get(i, u, v, w)
+// yields record i and returns false for records to skip; degree[] counts
+// only the E records that are kept.
+template <class Get>
+static graph* buildgraph(int V, int records, int E, const int* degree, Get get) {
+    graph* g = new graph(V);
+    if (E == 0) return g;
+
+    singlenode* block = g->allocblock(E);
+    int* cursor = new int[V];
+    int at = 0;
+    for (int i = 0; i < V; i++) {
+        at += degree[i];
+        cursor[i] = at;
+    }
+
+    int u, v;
+    double w;
+    for (int i = 0; i < records; i++) {
+        if (!get(i, u, v, w)) continue;
+        singlenode* n = &block[--cursor[u]];
+        n->vertex = v;
+        n->weight = w;
+    }
+
+    // cursor[u] now marks the start of u's run.
+    for (int i = 0; i < V; i++) {
+        int end = cursor[i] + degree[i];
+        if (cursor[i] == end) continue;
+        for (int k = cursor[i]; k < end - 1; k++) block[k].nextnode = &block[k + 1];
+        block[end - 1].nextnode = 0;
+        g->array[i] = &block[cursor[i]];
+    }
+    delete[] cursor;
+    return g;
+}
+
+static bool isspace_(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool parseint(const char*& p, const char* end, int& out) {
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = *p == '-';
+        p++;
+    }
+    const char* start = p;
+    long long val = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        val = val * 10 + (*p - '0');
+        if (val > INT_MAX) return false;
+        p++;
+    }
+    if (p == start) return false;
+    out = (int)(neg ? -val : val);
+    return true;
+}
+
+// Plain decimals with at most 15 significant digits are exact as
+// mantissa / 10^frac; anything else (exponents, inf, long mantissas) goes
+// through strtod on a terminated copy of the token.
+static bool parsedouble(const char*& p, const char* end, double& out) {
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                   1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    const char* token = p;
+    const char* q = p;
+    bool neg = false;
+    if (q < end && (*q == '-' || *q == '+')) {
+        neg = *q == '-';
+        q++;
+    }
+    long long mant = 0;
+    int digits = 0, frac = 0;
+    bool dot = false;
+    for (; q < end; q++) {
+        if (*q >= '0' && *q <= '9') {
+            mant = mant * 10 + (*q - '0');
+            if (++digits > 15) break;
+            if (dot) frac++;
+        } else if (*q == '.' && !dot) {
+            dot = true;
+        } else {
+            break;
+        }
+    }
+    if (digits > 0 && digits <= 15 && (q == end || isspace_(*q) || *q == '\n')) {
+        out = (double)mant / pow10[frac];
+        if (neg) out = -out;
+        p = q;
+        return true;
+    }
+
+    const char* tend = token;
+    while (tend < end && !isspace_(*tend) && *tend != '\n') tend++;
+    char buf[64];
+    int n = (int)(tend - token);
+    if (n == 0 || n >= (int)sizeof(buf)) return false;
+    memcpy(buf, token, n);
+    buf[n] = 0;
+    char* stop;
+    out = strtod(buf, &stop);
+    if (stop != buf + n) return false;
+    p = tend;
+    return true;
+}
+
+// Parses every line in [p, end). The caller guarantees the range ends on
+// a line boundary (or at end of input).
+static bool parselines(const char* p, const char* end, edgebuffer& eb) {
+    while (p < end) {
+        while (p < end && isspace_(*p)) p++;
+        if (p == end) break;
+        if (*p == '\n') {
+            p++;
+            continue;
+        }
+        if (*p == '#' || *p == '%') {
+            while (p < end && *p != '\n') p++;
+            continue;
+        }
+
+        int u, v;
+        double w = 1;
+        if (!parseint(p, end, u) || u < 0) return false;
+        while (p < end && isspace_(*p)) p++;
+        if (!parseint(p, end, v) || v < 0) return false;
+        while (p < end && isspace_(*p)) p++;
+        if (p < end && *p != '\n' && !parsedouble(p, end, w)) return false;
+        while (p < end && isspace_(*p)) p++;
+        if (p < end && *p != '\n') return false;
+
+        int top = u > v ? u : v;
+        if (top >= (int)eb.degree.size()) eb.degree.resize((size_t)top + 1, 0);
+        eb.degree[u]++;
+        eb.src.push_back(u);
+        eb.dst.push_back(v);
+        eb.w.push_back(w);
+    }
+    return true;
+}
+
+static graph* buildfrom(edgebuffer& eb) {
+    if (eb.src.size() > (size_t)INT_MAX) return 0;
+    const int* src = eb.src.data();
+    const int* dst = eb.dst.data();
+    const double* wt = eb.w.data();
+    int E = (int)eb.src.size();
+    return buildgraph((int)eb.degree.size(), E, E, eb.degree.data(),
+                      [&](int i, int& u, int& v, double& w) {
+                          u = src[i];
+                          v = dst[i];
+                          w = wt[i];
+                          return true;
+                      });
+}
+
+graph* loadEdgeListText(const char* buf, long long len) {
+    edgebuffer eb;
+    if (!parselines(buf, buf + len, eb)) return 0;
+    return buildfrom(eb);
+}
+
+graph* loadEdgeListText(std::istream& in) {
+    const size_t chunk = 1 << 20;
+    std::vector<char> buf;
+    size_t carry = 0;
+    edgebuffer eb;
+
+    while (true) {
+        buf.resize(carry + chunk);
+        in.read(buf.data() + carry, chunk);
+        size_t got = (size_t)in.gcount();
+        size_t filled = carry + got;
+        bool eof = got == 0;
+
+        // Parse up to the last complete line; keep the tail for next time.
+        size_t cut = filled;
+        if (!eof) {
+            while (cut > 0 && buf[cut - 1] != '\n') cut--;
+            if (cut == 0) {
+                carry = filled;
+                continue;
+            }
+        }
+        if (!parselines(buf.data(), buf.data() + cut, eb)) return 0;
+        if (eof) break;
+
+        carry = filled - cut;
+        memmove(buf.data(), buf.data() + cut, carry);
+    }
+    return buildfrom(eb);
+}
+
+graph* loadEdgeListBinary(const void* buf, long long len) {
+    if (len < (long long)sizeof(edgefileheader)) return 0;
+    const edgefileheader* h = (const edgefileheader*)buf;
+    if (memcmp(h->magic, "DSEG", 4) != 0 || h->vertices < 0 || h->edges < 0) return 0;
+    if (h->edges > INT_MAX) return 0;
+    if (h->edges > (len - (long long)sizeof(edgefileheader)) / (long long)sizeof(edgerecord))
+        return 0;
+
+    int V = h->vertices;
+    int E = (int)h->edges;
+    const edgerecord* rec = (const edgerecord*)(h + 1);
+
+    int* degree = new int[V > 0 ? V : 1];
+    for (int i = 0; i < V; i++) degree[i] = 0;
+    int kept = 0;
+    for (int i = 0; i < E; i++) {
+        int u = rec[i].u, v = rec[i].v;
+        if (u < 0 || v < 0 || u >= V || v >= V) continue;
+        degree[u]++;
+        kept++;
+    }
+
+    graph* g = buildgraph(V, E, kept, degree, [&](int i, int& u, int& v, double& w) {
+        u = rec[i].u;
+        v = rec[i].v;
+        w = rec[i].w;
+        return u >= 0 && v >= 0 && u < V && v < V;
+    });
+    delete[] degree;
+    return g;
+}
+
+graph* loadEdgeListBinaryFile(const char* path) {
+#if defined(_WIN32)
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    std::vector<char> buf((size_t)len);
+    size_t got = fread(buf.data(), 1, (size_t)len, f);
+    fclose(f);
+    if ((long long)got != len) return 0;
+    return loadEdgeListBinary(buf.data(), len);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    void* map = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+#ifdef MADV_SEQUENTIAL
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+    graph* g = loadEdgeListBinary(map, (long long)st.st_size);
+    munmap(map, (size_t)st.st_size);
+    return g;
+#endif
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+#include <istream>
+#include "graph.h"
+
+// Binary edge file layout: one header followed by `edges` records, both
+// in host byte order. Records whose endpoints fall outside
+// [0, vertices) are skipped.
+struct edgefileheader {
+    char magic[4];      // "DSEG"
+    int32_t vertices;
+    int64_t edges;
+};
+
+struct edgerecord {
+    int32_t u;
+    int32_t v;
+    double w;
+};
+
+// Text edge lists hold one "u v [w]" per line (w defaults to 1); blank
+// lines and lines starting with '#' or '%' are ignored. The vertex count
+// is the largest id seen plus one.
+//
+// All loaders count degrees while reading, then lay every vertex's edges
+// out contiguously in a single block owned by the graph, linked in the
+// order repeated addedge calls would produce. They return null on
+// malformed input.
+graph* loadEdgeListText(std::istream& in);
+graph* loadEdgeListText(const char* buf, long long len);
+graph* loadEdgeListBinary(const void* buf, long long len);
+// Maps the file read-only instead of copying it in.
+graph* loadEdgeListBinaryFile(const char* path);
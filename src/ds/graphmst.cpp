@@ -0,0 +1,146 @@
+#include "graph.h"
+#include "disjointset.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Edges are ranked by (weight, edge index). A strict total order keeps
+// Boruvka from closing a cycle when several edges tie on weight.
+static bool lighter(const graphcsr* c, int a, int b) {
+    if (c->weights[a] != c->weights[b]) return c->weights[a] < c->weights[b];
+    return a < b;
+}
+
+// Lowers best[comp] to edge k if k is lighter than what it holds.
+static void offer(std::atomic<int>* best, int comp, const graphcsr* c, int k) {
+    int cur = best[comp].load(std::memory_order_relaxed);
+    while ((cur == -1 || lighter(c, k, cur)) &&
+           !best[comp].compare_exchange_weak(cur, k, std::memory_order_relaxed)) {
+    }
+}
+
+// Source vertex of every CSR edge.
+static int* edgesources(const graphcsr* c) {
+    int* src = new int[c->E > 0 ? c->E : 1];
+    threadpool::shared().parallelfor(c->V, 1024, [&](int b, int e, int) {
+        for (int u = b; u < e; u++)
+            for (int k = c->offsets[u]; k < c->offsets[u + 1]; k++) src[k] = u;
+    });
+    return src;
+}
+
+int graph::boruvka(int* outEdges, double* outWeights) {
+    graphcsr* c = snapshot();
+    bool owned = c == 0;
+    if (owned) c = buildcsr(false);
+
+    threadpool& pool = threadpool::shared();
+    int* src = edgesources(c);
+    int* comp = new int[V > 0 ? V : 1];
+    std::atomic<int>* best = new std::atomic<int>[V > 0 ? V : 1];
+    disjointset ds(V);
+    int count = 0;
+
+    bool merged = true;
+    while (merged) {
+        merged = false;
+
+        // Unions only happen in the serial step below, so the read-only
+        // finds here can run in parallel.
+        pool.parallelfor(V, 1024, [&](int b, int e, int) {
+            for (int v = b; v < e; v++) {
+                comp[v] = ds.findconst(v);
+                best[v].store(-1, std::memory_order_relaxed);
+            }
+        });
+
+        // Cheapest edge leaving every component. Edges are undirected, so
+        // each one is offered to the components at both of its ends.
+        pool.parallelfor(c->E, 4096, [&](int b, int e, int) {
+            for (int k = b; k < e; k++) {
+                int cu = comp[src[k]];
+                int cv = comp[c->targets[k]];
+                if (cu == cv) continue;
+                offer(best, cu, c, k);
+                offer(best, cv, c, k);
+            }
+        });
+
+        for (int v = 0; v < V; v++) {
+            if (comp[v] != v) continue;
+            int k = best[v].load(std::memory_order_relaxed);
+            if (k < 0) continue;
+            // Both endpoints may have picked the same edge; unite skips it.
+            if (!ds.unite(src[k], c->targets[k])) continue;
+            outEdges[2 * count] = src[k];
+            outEdges[2 * count + 1] = c->targets[k];
+            outWeights[count] = c->weights[k];
+            count++;
+            merged = true;
+        }
+    }
+
+    delete[] src;
+    delete[] comp;
+    delete[] best;
+    if (owned) delete c;
+    return count;
+}
+
+int graph::kruskal(int* outEdges, double* outWeights) {
+    graphcsr* c = snapshot();
+    bool owned = c == 0;
+    if (owned) c = buildcsr(false);
+
+    threadpool& pool = threadpool::shared();
+    int E = c->E;
+    int* src = edgesources(c);
+    int* order = new int[E > 0 ? E : 1];
+    int* tmp = new int[E > 0 ? E : 1];
+    for (int k = 0; k < E; k++) order[k] = k;
+    auto less = [&](int a, int b) { return lighter(c, a, b); };
+
+    // Parallel merge sort: sort one run per thread, then merge runs
+    // pairwise, doubling the run length each pass.
+    int runs = pool.size();
+    int run = (E + runs - 1) / (runs > 0 ? runs : 1);
+    if (run < 1) run = 1;
+    int nruns = (E + run - 1) / run;
+    pool.parallelfor(nruns, 1, [&](int b, int e, int) {
+        for (int r = b; r < e; r++) {
+            int lo = r * run;
+            int hi = std::min(E, lo + run);
+            std::sort(order + lo, order + hi, less);
+        }
+    });
+    for (; run < E; run *= 2) {
+        int pairs = (E + 2 * run - 1) / (2 * run);
+        pool.parallelfor(pairs, 1, [&](int b, int e, int) {
+            for (int p = b; p < e; p++) {
+                int lo = p * 2 * run;
+                int mid = std::min(E, lo + run);
+                int hi = std::min(E, lo + 2 * run);
+                std::merge(order + lo, order + mid, order + mid, order + hi, tmp + lo, less);
+            }
+        });
+        std::swap(order, tmp);
+    }
+
+    disjointset ds(V);
+    int count = 0;
+    for (int i = 0; i < E && count < V - 1; i++) {
+        int k = order[i];
+        if (!ds.unite(src[k], c->targets[k])) continue;
+        outEdges[2 * count] = src[k];
+        outEdges[2 * count + 1] = c->targets[k];
+        outWeights[count] = c->weights[k];
+        count++;
+    }
+
+    delete[] src;
+    delete[] order;
+    delete[] tmp;
+    if (owned) delete c;
+    return count;
+}
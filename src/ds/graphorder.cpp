@@ -0,0 +1,129 @@
+#include "graph.h"
+#include <algorithm>
+#include <vector>
+
+// Vertex sequence (by old id) for each strategy. Degrees and BFS
+// neighbourhoods use the undirected view: out-edges plus in-edges.
+static void degreeorder(const graphcsr* out, const graphcsr* in, const bool* live,
+                        std::vector<int>& seq) {
+    int V = out->V;
+    for (int v = 0; v < V; v++)
+        if (live[v]) seq.push_back(v);
+    std::stable_sort(seq.begin(), seq.end(), [&](int a, int b) {
+        int da = out->offsets[a + 1] - out->offsets[a] + in->offsets[a + 1] - in->offsets[a];
+        int db = out->offsets[b + 1] - out->offsets[b] + in->offsets[b + 1] - in->offsets[b];
+        return da > db;
+    });
+}
+
+// Breadth-first from each unvisited vertex in turn. With sortbydegree the
+// roots are minimum-degree vertices and neighbours are queued by
+// ascending degree (Cuthill-McKee).
+static void bfsorder(const graphcsr* out, const graphcsr* in, const bool* live,
+                     bool sortbydegree, std::vector<int>& seq) {
+    int V = out->V;
+    std::vector<int> degree(V);
+    for (int v = 0; v < V; v++)
+        degree[v] = out->offsets[v + 1] - out->offsets[v] + in->offsets[v + 1] - in->offsets[v];
+
+    std::vector<int> roots;
+    for (int v = 0; v < V; v++)
+        if (live[v]) roots.push_back(v);
+    if (sortbydegree)
+        std::stable_sort(roots.begin(), roots.end(),
+                         [&](int a, int b) { return degree[a] < degree[b]; });
+
+    std::vector<bool> seen(V, false);
+    std::vector<int> nbrs;
+    for (size_t r = 0; r < roots.size(); r++) {
+        int root = roots[r];
+        if (seen[root]) continue;
+        seen[root] = true;
+        size_t head = seq.size();
+        seq.push_back(root);
+        while (head < seq.size()) {
+            int u = seq[head++];
+            nbrs.clear();
+            for (int k = out->offsets[u]; k < out->offsets[u + 1]; k++) nbrs.push_back(out->targets[k]);
+            for (int k = in->offsets[u]; k < in->offsets[u + 1]; k++) nbrs.push_back(in->targets[k]);
+            if (sortbydegree)
+                std::stable_sort(nbrs.begin(), nbrs.end(),
+                                 [&](int a, int b) { return degree[a] < degree[b]; });
+            for (size_t i = 0; i < nbrs.size(); i++) {
+                int v = nbrs[i];
+                if (seen[v]) continue;
+                seen[v] = true;
+                seq.push_back(v);
+            }
+        }
+    }
+}
+
+void graph::reorder(int mode, int* outNewId, int* outOldId) {
+    graphcsr* out = buildcsr(false);
+    graphcsr* in = buildcsr(true);
+    bool* live = new bool[V > 0 ? V : 1];
+    for (int v = 0; v < V; v++) live[v] = valid(v);
+
+    std::vector<int> seq;
+    seq.reserve(V);
+    if (mode == REORDER_DEGREE) degreeorder(out, in, live, seq);
+    else bfsorder(out, in, live, mode == REORDER_RCM, seq);
+    if (mode == REORDER_RCM) std::reverse(seq.begin(), seq.end());
+    delete out;
+    delete in;
+
+    // Tombstones keep their free-list role, after every live vertex.
+    for (int v = 0; v < V; v++)
+        if (!live[v]) seq.push_back(v);
+    delete[] live;
+
+    int* perm = new int[V > 0 ? V : 1];
+    for (int i = 0; i < V; i++) perm[seq[i]] = i;
+    permute(perm);
+
+    if (outNewId)
+        for (int i = 0; i < V; i++) outNewId[i] = perm[i];
+    if (outOldId)
+        for (int i = 0; i < V; i++) outOldId[i] = seq[i];
+    delete[] perm;
+}
+
+void graph::permute(const int* perm) {
+    invalidate();
+
+    singlenode** newarr = new singlenode*[cap];
+    for (int i = 0; i < V; i++) {
+        for (singlenode* t = array[i]; t; t = t->nextnode) t->vertex = perm[t->vertex];
+        newarr[perm[i]] = array[i];
+    }
+    delete[] array;
+    array = newarr;
+
+    if (inarray) {
+        singlenode** newin = new singlenode*[cap];
+        for (int i = 0; i < V; i++) {
+            for (singlenode* t = inarray[i]; t; t = t->nextnode) t->vertex = perm[t->vertex];
+            newin[perm[i]] = inarray[i];
+        }
+        delete[] inarray;
+        inarray = newin;
+    }
+    if (alive) {
+        bool* newalive = new bool[cap];
+        for (int i = 0; i < V; i++) newalive[perm[i]] = alive[i];
+        delete[] alive;
+        alive = newalive;
+        for (int i = 0; i < freecount; i++) freeids[i] = perm[freeids[i]];
+    }
+    if (coords) {
+        double* newcoords = new double[2 * cap];
+        for (int i = 0; i < V; i++) {
+            newcoords[2 * perm[i]] = coords[2 * i];
+            newcoords[2 * perm[i] + 1] = coords[2 * i + 1];
+        }
+        delete[] coords;
+        coords = newcoords;
+    }
+    if (spt) spt->relabel(perm);
+}
@@ -0,0 +1,192 @@
+#include "graph.h"
+#include <math.h>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+static const double INF = std::numeric_limits<double>::infinity();
+
+typedef std::pair<double, int> queued;
+typedef std::priority_queue<queued, std::vector<queued>, std::greater<queued> > minqueue;
+
+// A* queue entry: f = g + h orders the queue, g detects stale entries.
+struct astarentry {
+    double f;
+    double g;
+    int v;
+    bool operator>(const astarentry& o) const { return f > o.f; }
+};
+
+// Writes s..meet by following forward parents, then meet..t by following
+// backward parents when the backward search reached meet.
+int graph::tracepath(int meet, int t, int* outPath, int cap) {
+    int st = scratch.stamp;
+    int front = 0;
+    for (int v = meet; v != -1; v = scratch.parent[v]) front++;
+    int back = 0;
+    if (scratch.seen2[meet] == st)
+        for (int v = meet; v != t; v = scratch.parent2[v]) back++;
+
+    int len = front + back;
+    if (len > cap || !outPath) return len;
+    int i = front - 1;
+    for (int v = meet; v != -1; v = scratch.parent[v]) outPath[i--] = v;
+    i = front;
+    if (back)
+        for (int v = scratch.parent2[meet];; v = scratch.parent2[v]) {
+            outPath[i++] = v;
+            if (v == t) break;
+        }
+    return len;
+}
+
+double graph::shortestPath(int s, int t, int* outPath, int cap, int& outLen) {
+    outLen = 0;
+    if (!valid(s) || !valid(t)) return INF;
+
+    snapshot();
+    if (!transposed()) enableReverseIndex();
+    scratch.reserve(V);
+    int st = scratch.nextstamp();
+    double* df = scratch.key;
+    double* db = scratch.key2;
+    int* pf = scratch.parent;
+    int* pb = scratch.parent2;
+    int* sf = scratch.seen;
+    int* sb = scratch.seen2;
+
+    df[s] = 0;
+    pf[s] = -1;
+    sf[s] = st;
+    db[t] = 0;
+    pb[t] = -1;
+    sb[t] = st;
+
+    double mu = s == t ? 0 : INF;
+    int meet = s == t ? s : -1;
+    minqueue qf, qb;
+    qf.push(queued(0, s));
+    qb.push(queued(0, t));
+
+    while (!qf.empty() && !qb.empty()) {
+        // No path through an unsettled vertex can beat mu any more.
+        if (qf.top().first + qb.top().first >= mu) break;
+
+        if (qf.top().first <= qb.top().first) {
+            queued top = qf.top();
+            qf.pop();
+            int u = top.second;
+            if (top.first > df[u]) continue;
+            forEachEdge(u, [&](int v, double w) {
+                double nd = df[u] + w;
+                if (sf[v] == st && nd >= df[v]) return;
+                df[v] = nd;
+                pf[v] = u;
+                sf[v] = st;
+                qf.push(queued(nd, v));
+                if (sb[v] == st && nd + db[v] < mu) {
+                    mu = nd + db[v];
+                    meet = v;
+                }
+            });
+        } else {
+            queued top = qb.top();
+            qb.pop();
+            int u = top.second;
+            if (top.first > db[u]) continue;
+            forEachInEdge(u, [&](int v, double w) {
+                double nd = db[u] + w;
+                if (sb[v] == st && nd >= db[v]) return;
+                db[v] = nd;
+                pb[v] = u;
+                sb[v] = st;
+                qb.push(queued(nd, v));
+                if (sf[v] == st && nd + df[v] < mu) {
+                    mu = nd + df[v];
+                    meet = v;
+                }
+            });
+        }
+    }
+
+    if (meet < 0) return INF;
+    outLen = tracepath(meet, t, outPath, cap);
+    return mu;
+}
+
+double graph::astar(int s, int t, heuristicfn h, void* ctx, int* outPath, int cap, int& outLen) {
+    outLen = 0;
+    if (!valid(s) || !valid(t)) return INF;
+
+    snapshot();
+    scratch.reserve(V);
+    int st = scratch.nextstamp();
+    double* g = scratch.key;
+    int* parent = scratch.parent;
+    int* seen = scratch.seen;
+
+    g[s] = 0;
+    parent[s] = -1;
+    seen[s] = st;
+
+    std::priority_queue<astarentry, std::vector<astarentry>, std::greater<astarentry> > q;
+    astarentry first = {h(s, t, ctx), 0, s};
+    q.push(first);
+
+    bool found = false;
+    while (!q.empty()) {
+        astarentry top = q.top();
+        q.pop();
+        int u = top.v;
+        if (top.g > g[u]) continue;
+        if (u == t) {
+            found = true;
+            break;
+        }
+        forEachEdge(u, [&](int v, double w) {
+            double nd = g[u] + w;
+            if (seen[v] == st && nd >= g[v]) return;
+            g[v] = nd;
+            parent[v] = u;
+            seen[v] = st;
+            astarentry e = {nd + h(v, t, ctx), nd, v};
+            q.push(e);
+        });
+    }
+
+    if (!found) return INF;
+    outLen = tracepath(t, t, outPath, cap);
+    return g[t];
+}
+
+struct euclidctx {
+    const double* xy;
+    double scale;
+};
+
+static double euclidean(int v, int t, void* ctx) {
+    euclidctx* c = (euclidctx*)ctx;
+    double dx = c->xy[2 * v] - c->xy[2 * t];
+    double dy = c->xy[2 * v + 1] - c->xy[2 * t + 1];
+    return c->scale * sqrt(dx * dx + dy * dy);
+}
+
+static double zero(int, int, void*) {
+    return 0;
+}
+
+double graph::astarEuclidean(int s, int t, double scale, int* outPath, int cap, int& outLen) {
+    // Without coordinates A* degrades to Dijkstra with early exit.
+    if (!coords) return astar(s, t, zero, 0, outPath, cap, outLen);
+    euclidctx ctx = {coords, scale};
+    return astar(s, t, euclidean, &ctx, outPath, cap, outLen);
+}
+
+void graph::setCoordinates(const double* xy, int n) {
+    if (!coords) coords = new double[2 * (cap > 0 ? cap : 1)];
+    if (n > V) n = V;
+    for (int i = 0; i < 2 * n; i++) coords[i] = xy[i];
+    for (int i = 2 * n; i < 2 * V; i++) coords[i] = 0;
+}
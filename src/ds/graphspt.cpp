@@ -0,0 +1,248 @@
+#include "graphspt.h"
+#include "graph.h"
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+static const double INF = std::numeric_limits<double>::infinity();
+
+typedef std::pair<double, int> queued;
+typedef std::priority_queue<queued, std::vector<queued>, std::greater<queued> > minqueue;
+
+spttree::spttree(int s, int n) {
+    source = s;
+    cap = n > 0 ? n : 1;
+    dist = new double[cap];
+    parent = new int[cap];
+}
+
+spttree::~spttree() {
+    delete[] dist;
+    delete[] parent;
+}
+
+sptcache::sptcache(graph* owner) {
+    g = owner;
+    mark = 0;
+    markcap = 0;
+    stamp = 0;
+}
+
+sptcache::~sptcache() {
+    for (size_t i = 0; i < trees.size(); i++) delete trees[i];
+    delete[] mark;
+}
+
+spttree* sptcache::find(int source) {
+    for (size_t i = 0; i < trees.size(); i++)
+        if (trees[i]->source == source) return trees[i];
+    return 0;
+}
+
+void sptcache::track(int source) {
+    if (find(source)) return;
+    spttree* t = new spttree(source, g->cap);
+    trees.push_back(t);
+    recompute(t);
+}
+
+void sptcache::untrack(int source) {
+    for (size_t i = 0; i < trees.size(); i++) {
+        if (trees[i]->source != source) continue;
+        delete trees[i];
+        trees.erase(trees.begin() + i);
+        return;
+    }
+}
+
+void sptcache::recompute(spttree* t) {
+    g->dijkstra(t->source, t->dist, t->parent);
+}
+
+void sptcache::recomputeall() {
+    for (size_t i = 0; i < trees.size(); i++) recompute(trees[i]);
+}
+
+void sptcache::vertexadded(int u) {
+    grow(g->cap);
+    for (size_t i = 0; i < trees.size(); i++) {
+        trees[i]->dist[u] = INF;
+        trees[i]->parent[u] = -1;
+    }
+}
+
+void sptcache::grow(int n) {
+    for (size_t i = 0; i < trees.size(); i++) {
+        spttree* t = trees[i];
+        if (n <= t->cap) continue;
+        double* dist = new double[n];
+        int* parent = new int[n];
+        for (int k = 0; k < t->cap; k++) {
+            dist[k] = t->dist[k];
+            parent[k] = t->parent[k];
+        }
+        for (int k = t->cap; k < n; k++) {
+            dist[k] = INF;
+            parent[k] = -1;
+        }
+        delete[] t->dist;
+        delete[] t->parent;
+        t->dist = dist;
+        t->parent = parent;
+        t->cap = n;
+    }
+}
+
+void sptcache::nextstamp() {
+    if (markcap < g->cap) {
+        delete[] mark;
+        markcap = g->cap;
+        mark = new int[markcap];
+        for (int i = 0; i < markcap; i++) mark[i] = 0;
+        stamp = 0;
+    }
+    stamp++;
+}
+
+// dist[v] just dropped: push the improvement through v's out-edges.
+void sptcache::improve(spttree* t, int v) {
+    minqueue q;
+    q.push(queued(t->dist[v], v));
+    while (!q.empty()) {
+        queued top = q.top();
+        q.pop();
+        int x = top.second;
+        if (top.first > t->dist[x]) continue;
+        for (singlenode* e = g->array[x]; e; e = e->nextnode) {
+            double nd = t->dist[x] + e->weight;
+            if (nd < t->dist[e->vertex]) {
+                t->dist[e->vertex] = nd;
+                t->parent[e->vertex] = x;
+                q.push(queued(nd, e->vertex));
+            }
+        }
+    }
+}
+
+// Collects root and everything below it in the tree. Tree children of y
+// are out-neighbours whose parent is y, so only the subtree's own edges
+// are scanned.
+void sptcache::subtree(spttree* t, int root, std::vector<int>& out) {
+    nextstamp();
+    out.clear();
+    out.push_back(root);
+    mark[root] = stamp;
+    for (size_t i = 0; i < out.size(); i++) {
+        int y = out[i];
+        for (singlenode* e = g->array[y]; e; e = e->nextnode) {
+            int x = e->vertex;
+            if (t->parent[x] == y && mark[x] != stamp) {
+                mark[x] = stamp;
+                out.push_back(x);
+            }
+        }
+    }
+}
+
+// Distances only grow on removal, so vertices outside the affected set
+// keep theirs. Each affected vertex restarts from its best in-edge from
+// outside the set, then a Dijkstra confined to the set settles the rest.
+void sptcache::repair(spttree* t, const std::vector<int>& affected) {
+    nextstamp();
+    for (size_t i = 0; i < affected.size(); i++) {
+        int x = affected[i];
+        mark[x] = stamp;
+        t->dist[x] = INF;
+        t->parent[x] = -1;
+    }
+
+    minqueue q;
+    for (size_t i = 0; i < affected.size(); i++) {
+        int x = affected[i];
+        if (!g->isAlive(x)) continue;
+        for (singlenode* e = g->inarray[x]; e; e = e->nextnode) {
+            int p = e->vertex;
+            if (mark[p] == stamp) continue;
+            double nd = t->dist[p] + e->weight;
+            if (nd < t->dist[x]) {
+                t->dist[x] = nd;
+                t->parent[x] = p;
+            }
+        }
+        if (t->dist[x] < INF) q.push(queued(t->dist[x], x));
+    }
+
+    while (!q.empty()) {
+        queued top = q.top();
+        q.pop();
+        int x = top.second;
+        if (top.first > t->dist[x]) continue;
+        for (singlenode* e = g->array[x]; e; e = e->nextnode) {
+            int y = e->vertex;
+            if (mark[y] != stamp) continue;
+            double nd = t->dist[x] + e->weight;
+            if (nd < t->dist[y]) {
+                t->dist[y] = nd;
+                t->parent[y] = x;
+                q.push(queued(nd, y));
+            }
+        }
+    }
+}
+
+void sptcache::edgeadded(int u, int v, double w) {
+    for (size_t i = 0; i < trees.size(); i++) {
+        spttree* t = trees[i];
+        double nd = t->dist[u] + w;
+        if (nd < t->dist[v]) {
+            t->dist[v] = nd;
+            t->parent[v] = u;
+            improve(t, v);
+        }
+    }
+}
+
+void sptcache::edgeremoved(int u, int v) {
+    std::vector<int> affected;
+    for (size_t i = 0; i < trees.size(); i++) {
+        spttree* t = trees[i];
+        if (t->parent[v] != u) continue;
+
+        // A parallel u -> v edge may still carry the same distance.
+        bool kept = false;
+        for (singlenode* e = g->array[u]; e && !kept; e = e->nextnode)
+            if (e->vertex == v && t->dist[u] + e->weight == t->dist[v]) kept = true;
+        if (kept) continue;
+
+        subtree(t, v, affected);
+        repair(t, affected);
+    }
+}
+
+void sptcache::vertexremoving(int u) {
+    pending.assign(trees.size(), std::vector<int>());
+    for (size_t i = 0; i < trees.size(); i++)
+        if (trees[i]->source != u) subtree(trees[i], u, pending[i]);
+}
+
+void sptcache::vertexremoved(int u) {
+    for (size_t i = 0; i < pending.size(); i++)
+        if (!pending[i].empty()) repair(trees[i], pending[i]);
+    pending.clear();
+    untrack(u);
+}
+
+void sptcache::relabel(const int* remap) {
+    for (size_t i = 0; i < trees.size();) {
+        int s = remap[trees[i]->source];
+        if (s < 0) {
+            delete trees[i];
+            trees.erase(trees.begin() + i);
+            continue;
+        }
+        trees[i]->source = s;
+        i++;
+    }
+    recomputeall();
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+
+class graph;
+
+// Shortest-path tree of one source, kept current as the graph changes.
+class spttree {
+public:
+    int source;
+    int cap;
+    double* dist;
+    int* parent;
+
+    spttree(int s, int n);
+    ~spttree();
+};
+
+// All tracked trees of a graph. graph calls the hooks below from its
+// mutators; each one only walks the region whose distances can change:
+//  - an added edge pushes improvements forward from its head,
+//  - a removed tree edge (or vertex) resets the subtree hanging below it
+//    and re-settles just that subtree from its in-edges.
+class sptcache {
+public:
+    graph* g;
+    std::vector<spttree*> trees;
+    // Per-tree affected sets collected by vertexremoving, repaired by
+    // vertexremoved once the vertex's edges are gone.
+    std::vector<std::vector<int> > pending;
+    int* mark;
+    int markcap;
+    int stamp;
+
+    sptcache(graph* owner);
+    ~sptcache();
+
+    spttree* find(int source);
+    void track(int source);
+    void untrack(int source);
+    void recompute(spttree* t);
+    void recomputeall();
+    void grow(int n);
+
+    void vertexadded(int u);
+    void edgeadded(int u, int v, double w);
+    void edgeremoved(int u, int v);
+    void vertexremoving(int u);
+    void vertexremoved(int u);
+    // Ids shifted under the trees: remap[old] is the new id or -1.
+    void relabel(const int* remap);
+
+private:
+    void improve(spttree* t, int v);
+    void subtree(spttree* t, int root, std::vector<int>& out);
+    void repair(spttree* t, const std::vector<int>& affected);
+    void nextstamp();
+};
@@ -0,0 +1,144 @@
+#include "graph.h"
+#include "threadpool.h"
+#include <limits>
+#include <vector>
+
+static const double INF = std::numeric_limits<double>::infinity();
+static const int MAXBUCKETS = 1 << 16;
+
+// A proposed relaxation of v, produced while dist[] is read-only.
+struct relaxrequest {
+    int v;
+    int parent;
+    double dist;
+};
+
+void graph::deltastepping(int start, double delta, double* outDist, int* outParent) {
+    if (!valid(start)) return;
+
+    graphcsr* c = snapshot();
+    bool owned = c == 0;
+    if (owned) c = buildcsr(false);
+
+    // Infinite weights never relax anything, so they do not size the ring.
+    double maxw = 0;
+    for (int e = 0; e < c->E; e++)
+        if (c->weights[e] > maxw && c->weights[e] < INF) maxw = c->weights[e];
+    if (!(delta > 0)) {
+        // Meyer & Sanders: delta around max weight / average degree keeps
+        // both the bucket count and the re-relaxations per bucket small.
+        double avgdeg = V > 0 ? (double)c->E / V : 1;
+        delta = avgdeg > 1 ? maxw / avgdeg : maxw;
+        if (delta <= 0) delta = 1;
+    }
+
+    // Tentative distances never run more than maxw past the bucket being
+    // settled, so a ring of maxw / delta + 2 buckets is enough. A caller's
+    // tiny delta is raised so the ring stays within MAXBUCKETS; a wider
+    // bucket only costs extra re-relaxations, never correctness.
+    if (!(delta >= maxw / (MAXBUCKETS - 2))) delta = maxw / (MAXBUCKETS - 2);
+    long long nb = (long long)(maxw / delta) + 2;
+    std::vector<std::vector<int> > buckets((size_t)nb);
+
+    double* dist = outDist;
+    int* parent = outParent;
+    int* seen = new int[V];
+    int* inrelaxed = new int[V];
+    for (int i = 0; i < V; i++) {
+        dist[i] = INF;
+        parent[i] = -1;
+        seen[i] = -1;
+        inrelaxed[i] = -1;
+    }
+
+    threadpool& pool = threadpool::shared();
+    int T = pool.size();
+    // requests[t * T + o] holds what thread t proposes for vertices owned
+    // by o (v % T), so the apply phase writes each dist[v] from one thread.
+    std::vector<std::vector<relaxrequest> > requests((size_t)T * T);
+    std::vector<std::vector<int> > improved(T);
+
+    auto relax = [&](const std::vector<int>& from, bool light) {
+        pool.parallelfor((int)from.size(), 128, [&](int b, int e, int tid) {
+            for (int i = b; i < e; i++) {
+                int u = from[i];
+                double du = dist[u];
+                for (int k = c->offsets[u]; k < c->offsets[u + 1]; k++) {
+                    double w = c->weights[k];
+                    if ((w <= delta) != light) continue;
+                    int v = c->targets[k];
+                    double nd = du + w;
+                    if (nd < dist[v]) {
+                        relaxrequest r = {v, u, nd};
+                        requests[(size_t)tid * T + v % T].push_back(r);
+                    }
+                }
+            }
+        });
+        pool.parallelfor(T, 1, [&](int b, int e, int) {
+            for (int o = b; o < e; o++) {
+                for (int t = 0; t < T; t++) {
+                    std::vector<relaxrequest>& rs = requests[(size_t)t * T + o];
+                    for (size_t i = 0; i < rs.size(); i++) {
+                        const relaxrequest& r = rs[i];
+                        if (r.dist < dist[r.v]) {
+                            dist[r.v] = r.dist;
+                            parent[r.v] = r.parent;
+                            improved[o].push_back(r.v);
+                        }
+                    }
+                    rs.clear();
+                }
+            }
+        });
+        for (int o = 0; o < T; o++) {
+            for (size_t i = 0; i < improved[o].size(); i++) {
+                int v = improved[o][i];
+                buckets[(size_t)((long long)(dist[v] / delta) % nb)].push_back(v);
+            }
+            improved[o].clear();
+        }
+    };
+
+    dist[start] = 0;
+    buckets[0].push_back(start);
+
+    long long cur = 0;
+    int round = 0, phase = 0;
+    std::vector<int> frontier, settled;
+    while (true) {
+        long long skip = 0;
+        while (skip < nb && buckets[(size_t)((cur + skip) % nb)].empty()) skip++;
+        if (skip == nb) break;
+        cur += skip;
+        std::vector<int>& bucket = buckets[(size_t)(cur % nb)];
+
+        // Light edges can refill the current bucket, so keep draining it;
+        // heavy edges go out once per vertex after it settles.
+        settled.clear();
+        while (!bucket.empty()) {
+            frontier.clear();
+            for (size_t i = 0; i < bucket.size(); i++) {
+                int v = bucket[i];
+                // Drop stale entries left behind by later improvements.
+                if ((long long)(dist[v] / delta) != cur || seen[v] == round) continue;
+                seen[v] = round;
+                frontier.push_back(v);
+                if (inrelaxed[v] != phase) {
+                    inrelaxed[v] = phase;
+                    settled.push_back(v);
+                }
+            }
+            bucket.clear();
+            round++;
+            relax(frontier, true);
+        }
+        relax(settled, false);
+        phase++;
+        cur++;
+    }
+
+    delete[] seen;
+    delete[] inrelaxed;
+    if (owned) delete c;
+}
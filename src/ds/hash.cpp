@@ -1,69 +1,148 @@
 #include "hash.h"
 #include <iostream>
 
+// Old buckets moved per insert/remove while a rehash is running.
+static const int REHASHSTEP = 8;
+
 HashTable::HashTable(int cap) {
-    capacity = cap;
+    capacity = cap > 0 ? cap : 1;
     size = 0;
+    tombstones = 0;
     table = new Entry[capacity];
+    oldtable = 0;
+    oldcapacity = 0;
+    migrated = 0;
 }
 
 HashTable::~HashTable() {
     delete[] table;
+    delete[] oldtable;
 }
-int HashTable::hashFunction(const std::string& key) const {
+unsigned long HashTable::hashFunction(const std::string& key) const {
     unsigned long hash = 5381;
     for (char c : key) {
         hash = ((hash << 5) + hash) + c;  
     }
-    return hash % capacity;
+    return hash;
 }
-int HashTable::probe(int index) const {
-    return (index + 1) % capacity;
+int HashTable::probe(int index, int cap) const {
+    return (index + 1) % cap;
 }
 
-bool HashTable::insert(const std::string& key, int value) {
-    if (size == capacity) return false; 
-    int index = hashFunction(key);
-    while (table[index].isOccupied && !table[index].isDeleted) {
-        if (table[index].key == key) {
-            table[index].value = value; 
-            return true;
-        }
-        index = probe(index);
+// Slot of key in t, or -1. The load cap keeps an empty slot in every
+// table, so the walk always ends.
+int HashTable::find(const Entry* t, int cap, const std::string& key) const {
+    int index = hashFunction(key) % cap;
+    while (t[index].isOccupied) {
+        if (!t[index].isDeleted && t[index].key == key) return index;
+        index = probe(index, cap);
     }
+    return -1;
+}
 
+// Adds a key known to be absent from both tables, reusing the first
+// tombstone on its chain.
+void HashTable::place(const std::string& key, int value) {
+    int index = hashFunction(key) % capacity;
+    while (table[index].isOccupied && !table[index].isDeleted) index = probe(index, capacity);
+    if (table[index].isDeleted) tombstones--;
     table[index].key = key;
     table[index].value = value;
     table[index].isOccupied = true;
     table[index].isDeleted = false;
+}
+
+// Doubles when live entries fill half the table; otherwise the load is
+// mostly tombstones and a same-size rebuild reclaims them.
+void HashTable::startRehash() {
+    if (oldtable) rehashStep(oldcapacity);
+    int newcap = capacity;
+    if ((size + 1) * 2 > capacity) newcap = capacity * 2;
+    while ((size + 1) * 4 > newcap * 3) newcap *= 2;
+
+    oldtable = table;
+    oldcapacity = capacity;
+    migrated = 0;
+    table = new Entry[newcap];
+    capacity = newcap;
+    tombstones = 0;
+}
+
+void HashTable::rehashStep(int buckets) {
+    if (!oldtable) return;
+    for (; buckets > 0 && migrated < oldcapacity; buckets--, migrated++) {
+        Entry& e = oldtable[migrated];
+        if (!e.isOccupied || e.isDeleted) continue;
+        place(e.key, e.value);
+        e.isDeleted = true;
+        e.key.clear();
+    }
+    if (migrated == oldcapacity) {
+        delete[] oldtable;
+        oldtable = 0;
+        oldcapacity = 0;
+    }
+}
+
+bool HashTable::insert(const std::string& key, int value) {
+    rehashStep(REHASHSTEP);
+
+    int index = find(table, capacity, key);
+    if (index < 0 && oldtable) {
+        // Not moved yet: update it where it is.
+        int old = find(oldtable, oldcapacity, key);
+        if (old >= 0) {
+            oldtable[old].value = value;
+            return true;
+        }
+    }
+    if (index >= 0) {
+        table[index].value = value;
+        return true;
+    }
+
+    if ((size + tombstones + 1) * 4 > capacity * 3) startRehash();
+    place(key, value);
     size++;
 
     return true;
 }
 
 bool HashTable::remove(const std::string& key) {
-    int index = hashFunction(key);
+    rehashStep(REHASHSTEP);
 
-    while (table[index].isOccupied) {
-        if (!table[index].isDeleted && table[index].key == key) {
-            table[index].isDeleted = true;
+    int index = find(table, capacity, key);
+    if (index >= 0) {
+        table[index].isDeleted = true;
+        table[index].key.clear();
+        tombstones++;
+        size--;
+        return true;
+    }
+    if (oldtable) {
+        index = find(oldtable, oldcapacity, key);
+        if (index >= 0) {
+            oldtable[index].isDeleted = true;
+            oldtable[index].key.clear();
             size--;
             return true;
         }
-        index = probe(index);
     }
 
     return false;
 }
 bool HashTable::search(const std::string& key, int &outValue) const {
-    int index = hashFunction(key);
-
-    while (table[index].isOccupied) {
-        if (!table[index].isDeleted && table[index].key == key) {
-            outValue = table[index].value;
+    int index = find(table, capacity, key);
+    if (index >= 0) {
+        outValue = table[index].value;
+        return true;
+    }
+    if (oldtable) {
+        index = find(oldtable, oldcapacity, key);
+        if (index >= 0) {
+            outValue = oldtable[index].value;
             return true;
         }
-        index = probe(index);
     }
     return false;
 }
@@ -76,4 +155,10 @@ void HashTable::print() const {
             std::cout << "[" << i << "] EMPTY\n";
         }
     }
+    if (!oldtable) return;
+    std::cout << "Not yet rehashed:\n";
+    for (int i = migrated; i < oldcapacity; i++) {
+        if (oldtable[i].isOccupied && !oldtable[i].isDeleted)
+            std::cout << "[" << i << "] "<< oldtable[i].key << " -> "<< oldtable[i].value << "\n";
+    }
 }
@@ -1,6 +1,14 @@
 #pragma once
 #include <string>
 
+// Open addressing with linear probing. The table grows (or, when the load
+// is mostly tombstones, is rebuilt at the same size) once live entries
+// plus tombstones would pass 3/4 of the capacity. The rebuild is
+// incremental: a fresh table is allocated, and every insert/remove
+// moves the next REHASHSTEP buckets of the old one across, so no single
+// call pays for the whole table. While both tables exist, lookups check
+// the new one and then the old one; moved entries leave tombstones so
+// the old table's probe chains stay intact.
 class HashTable {
 private:
     struct Entry {
@@ -14,10 +22,20 @@ private:
 
     Entry* table;
     int capacity;
-    int size;
+    int size;         // live entries in both tables
+    int tombstones;   // deleted entries in table
 
-    int hashFunction(const std::string& key) const;
-    int probe(int index) const;
+    // Table being drained, null when no rehash is running.
+    Entry* oldtable;
+    int oldcapacity;
+    int migrated;     // old buckets below this index have been moved
+
+    unsigned long hashFunction(const std::string& key) const;
+    int probe(int index, int cap) const;
+    int find(const Entry* t, int cap, const std::string& key) const;
+    void place(const std::string& key, int value);
+    void startRehash();
+    void rehashStep(int buckets);
 
 public:
     HashTable(int cap = 100);
@@ -28,5 +46,7 @@ public:
     bool search(const std::string& key, int &outValue) const;
 
     int getSize() const { return size; }
+    int getCapacity() const { return capacity; }
+    bool isRehashing() const { return oldtable != 0; }
     void print() const;
 };
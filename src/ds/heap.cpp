@@ -1,109 +1,85 @@
 #include "heap.h"
 
-heap::heap() {
-    size = 0;
-}
+static const int HEAPMIN = 16;
 
-void heap::insertmin(int value) {
-    size++;
-    arr[size] = value;
-    bubbleupminitr(size);
+heap::heap() : h(HEAPMIN) {
+    h.cmp.mode = HEAP_MAX;
 }
 
-void heap::insertmax(int value) {
-    size++;
-    arr[size] = value;
-    bubbleupmaxitr(size);
+// Existing elements were ordered for the old mode; re-heapify them.
+void heap::setMode(int m) {
+    if (m == h.cmp.mode) return;
+    h.cmp.mode = m;
+    h.heapify();
 }
 
-void heap::bubbleupminrec(int i) {
-    if (i <= 1) return;
-    if (arr[i] < arr[i / 2]) {
-        int t = arr[i];
-        arr[i] = arr[i / 2];
-        arr[i / 2] = t;
-    }
-    bubbleupminrec(i / 2);
+void heap::insertmin(int value) {
+    setMode(HEAP_MIN);
+    h.push(value);
 }
 
-void heap::bubbleupmaxrec(int i) {
-    if (i <= 1) return;
-    if (arr[i] > arr[i / 2]) {
-        int t = arr[i];
-        arr[i] = arr[i / 2];
-        arr[i / 2] = t;
-    }
-    bubbleupmaxrec(i / 2);
+void heap::insertmax(int value) {
+    setMode(HEAP_MAX);
+    h.push(value);
 }
 
-void heap::bubbleupminitr(int i) {
-    while (i > 1) {
-        if (arr[i] < arr[i / 2]) {
-            int t = arr[i];
-            arr[i] = arr[i / 2];
-            arr[i / 2] = t;
-        }
-        i = i / 2;
-    }
+void heap::deleteelement() {
+    h.pop();
 }
 
-void heap::bubbleupmaxitr(int i) {
-    while (i > 1) {
-        if (arr[i] > arr[i / 2]) {
-            int t = arr[i];
-            arr[i] = arr[i / 2];
-            arr[i / 2] = t;
-        }
-        i = i / 2;
-    }
+int heap::getSize() const {
+    return h.size();
 }
 
-void heap::deleteelement() {
-    if (size == 0) return;
-    arr[1] = arr[size];
-    size--;
-    bubbledownitr(1);
+int heap::getElement(int index) const {
+    if (index < 1 || index > h.size()) return -1;
+    return h[index - 1];
 }
 
-void heap::bubbledownitr(int i) {
-    while (true) {
-        int left = 2 * i;
-        int right = 2 * i + 1;
-        int largest = i;
-
-        if (left <= size && arr[left] > arr[largest]) largest = left;
-        if (right <= size && arr[right] > arr[largest]) largest = right;
+void heap::buildFrom(const int* values, int n, int m) {
+    h.cmp.mode = m;
+    h.clear();
+    h.reserve(n);
+    for (int i = 0; i < n; i++) h.a[i] = values[i];
+    h.n = n;
+    h.heapify();
+}
 
-        if (largest != i) {
-            int t = arr[largest];
-            arr[largest] = arr[i];
-            arr[i] = t;
-            i = largest;
-        } else break;
+void heap::insertBatch(const int* values, int n) {
+    if (n <= 0) return;
+    int old = h.n;
+    h.reserve(old + n);
+    for (int i = 0; i < n; i++) h.a[old + i] = values[i];
+    h.n = old + n;
+    if (n >= old) {
+        h.heapify();
+    } else {
+        for (int i = old; i < h.n; i++) h.siftup(i);
     }
 }
 
-void heap::bubbledownrec(int i) {
-    int left = 2 * i;
-    int right = 2 * i + 1;
-    int largest = i;
-
-    if (left <= size && arr[left] > arr[largest]) largest = left;
-    if (right <= size && arr[right] > arr[largest]) largest = right;
-
-    if (largest != i) {
-        int t = arr[largest];
-        arr[largest] = arr[i];
-        arr[i] = t;
-        bubbledownrec(largest);
+int heap::extractK(int k, int* out) {
+    int taken = 0;
+    while (taken < k && !h.empty()) {
+        out[taken++] = h.top();
+        h.pop();
     }
+    return taken;
 }
 
-int heap::getSize() const {
-    return size;
+bool heap::replacetop(int value, int& old) {
+    if (h.empty()) {
+        h.push(value);
+        return false;
+    }
+    old = h.top();
+    h.replacetop(value);
+    return true;
 }
 
-int heap::getElement(int index) const {
-    if (index < 1 || index > size) return -1;
-    return arr[index];
+int heap::pushpop(int value) {
+    if (h.empty() || !h.cmp(h.top(), value)) return value;
+    int top = h.top();
+    h.replacetop(value);
+    return top;
 }
@@ -1,23 +1,58 @@
 #pragma once
+#include "dheap.h"
 
-class heap {
-public:
-    int arr[100];
-    int size;
+enum heapmode {
+    HEAP_MIN,
+    HEAP_MAX
+};
+
+// Order of the int heap, picked at run time.
+struct heaporder {
+    int mode;   // heapmode
+    bool operator()(int a, int b) const { return mode == HEAP_MIN ? a < b : a > b; }
+};
 
-    void bubbleupminrec(int i);
-    void bubbleupmaxrec(int i);
-    void bubbleupminitr(int i);
-    void bubbleupmaxitr(int i);
-    void bubbledownitr(int i);
-    void bubbledownrec(int i);
+// Arity of the int heap behind the bindings. Binary by default so that
+// getElement's 1-based slots keep the i / 2 parent layout the heap page
+// draws; -DDS_HEAP_ARITY=4 trades that for shallower pops.
+#ifndef DS_HEAP_ARITY
+#define DS_HEAP_ARITY 2
+#endif
 
+// The int heap the bindings use: a dheap (see dheap.h) whose min/max
+// order is switched by insertmin/insertmax, buildFrom and setMode.
+// Switching order on a non-empty heap re-heapifies it in O(n).
+class heap {
 public:
+    typedef dheap<int, heaporder, DS_HEAP_ARITY> store;
+    store h;
+
     heap();
 
+    int getMode() const { return h.cmp.mode; }
+    void setMode(int m);
+
     void insertmin(int value);
     void insertmax(int value);
     void deleteelement();
     int getSize() const;
+    // 1-based, as the bindings have always exposed it; -1 out of range.
     int getElement(int index) const;
+
+    // Replaces the contents with values[0..n) and heapifies bottom-up
+    // (Floyd) in O(n).
+    void buildFrom(const int* values, int n, int m);
+    // Adds n values in the current mode. A batch at least as large as the
+    // heap is appended and re-heapified in O(size); smaller ones are
+    // sifted up one by one.
+    void insertBatch(const int* values, int n);
+    // Pops up to k roots into out in priority order; returns how many.
+    int extractK(int k, int* out);
+
+    // Swaps the root for value in O(log n) and writes the old root to old.
+    // On an empty heap value is just inserted and false returned.
+    bool replacetop(int value, int& old);
+    // Pushes value and pops the root in one sift. When value would itself
+    // become the root it is returned untouched.
+    int pushpop(int value);
 };
@@ -0,0 +1,70 @@
+#include "heapstream.h"
+
+topk::topk(int k, bool largest) {
+    this->k = k;
+    this->largest = largest;
+    // The root is the worst value kept.
+    h.setMode(largest ? HEAP_MIN : HEAP_MAX);
+}
+
+void topk::push(int value) {
+    if (k <= 0) return;
+    if (h.getSize() < k) {
+        h.insertBatch(&value, 1);
+        return;
+    }
+    h.pushpop(value);
+}
+
+void topk::pushBatch(const int* values, int n) {
+    // Until the heap is full, values go straight in.
+    int fill = k - h.getSize();
+    if (fill > n) fill = n;
+    if (fill > 0) h.insertBatch(values, fill);
+    for (int i = fill > 0 ? fill : 0; i < n; i++) h.pushpop(values[i]);
+}
+
+int topk::extract(int* out) {
+    // The heap pops worst first, so fill out from the back.
+    int n = h.getSize();
+    for (int i = n - 1; i >= 0; i--) h.extractK(1, out + i);
+    return n;
+}
+
+kwaymerge::kwaymerge(const int* const* runs, const int* lens, int k, int mode) : h(k > 0 ? k : 1) {
+    this->runs = runs;
+    this->lens = lens;
+    h.cmp.descending = mode == HEAP_MAX;
+    pos = new int[k > 0 ? k : 1];
+    for (int r = 0; r < k; r++) {
+        pos[r] = 0;
+        if (lens[r] > 0) {
+            head e = {runs[r][0], r};
+            h.push(e);
+        }
+    }
+}
+
+kwaymerge::~kwaymerge() {
+    delete[] pos;
+}
+
+bool kwaymerge::next(int& out) {
+    if (h.empty()) return false;
+    head e = h.top();
+    out = e.value;
+    int r = e.run;
+    if (++pos[r] < lens[r]) {
+        e.value = runs[r][pos[r]];
+        h.replacetop(e);
+    } else {
+        h.pop();
+    }
+    return true;
+}
+
+int kwaymerge::read(int* out, int cap) {
+    int n = 0;
+    while (n < cap && next(out[n])) n++;
+    return n;
+}
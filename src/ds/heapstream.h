@@ -0,0 +1,56 @@
+#pragma once
+#include "heap.h"
+#include "dheap.h"
+
+// Keeps the k best values of a stream in O(log k) per value. For the k
+// largest the values sit in a min-heap of size k whose root is the worst
+// kept value, so each newcomer either bounces off the root or replaces
+// it in one pushpop.
+class topk {
+public:
+    heap h;
+    int k;
+    bool largest;
+
+    topk(int k, bool largest = true);
+
+    void push(int value);
+    void pushBatch(const int* values, int n);
+    int size() const { return h.getSize(); }
+    // Writes the kept values best first and returns how many; the
+    // accumulator is empty afterwards.
+    int extract(int* out);
+};
+
+// Merges k sorted runs (all ascending, or all descending with
+// HEAP_MAX) in O(n log k): a k-entry heap holds the head of every
+// non-empty run, and taking a value replaces that run's entry with its
+// next element.
+class kwaymerge {
+public:
+    struct head {
+        int value;
+        int run;
+    };
+    struct order {
+        bool descending;
+        bool operator()(const head& a, const head& b) const {
+            if (a.value != b.value) return descending ? a.value > b.value : a.value < b.value;
+            return a.run < b.run;   // ties come out in run order
+        }
+    };
+
+    const int* const* runs;
+    const int* lens;
+    int* pos;
+    dheap<head, order, 4> h;
+
+    kwaymerge(const int* const* runs, const int* lens, int k, int mode = HEAP_MIN);
+    ~kwaymerge();
+
+    bool done() const { return h.empty(); }
+    // Next merged value in out; false once every run is exhausted.
+    bool next(int& out);
+    // Up to cap next values into out; returns how many.
+    int read(int* out, int cap);
+};
@@ -0,0 +1,328 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// Addressable min-priority queues over the ids 0..n-1 with double keys.
+// The id is the handle: push(v, k) files v under k, decrease(v, k)
+// lowers the key of a queued v in place, and pop() removes and returns
+// the id with the smallest key. All three share this interface, so
+// graph algorithms take the queue as a template parameter:
+//
+//   daryipq<D>   implicit d-ary heap with a position index; decrease and
+//                pop are O(log n), decrease touches only the path up.
+//   pairingipq   pairing heap; O(1) push and decrease, amortized
+//                O(log n) pop. Good when most relaxations decrease keys.
+//   radixipq     monotone radix heap for non-negative keys that never go
+//                below the last popped key (Dijkstra with w >= 0). Keys
+//                are bucketed by their highest bit differing from the
+//                last pop, so each id moves buckets at most 64 times.
+//
+// reset(n) empties the queue and keeps its storage for reuse.
+
+template <int D>
+class daryipq {
+public:
+    std::vector<int> heap;   // ids in heap order
+    std::vector<int> pos;    // slot of each id, -1 when not queued
+    std::vector<double> keys;
+    int n;
+
+    daryipq() : n(0) {}
+
+    void reset(int ids) {
+        if ((int)pos.size() < ids) {
+            pos.resize(ids);
+            keys.resize(ids);
+            heap.resize(ids);
+        }
+        for (int i = 0; i < ids; i++) pos[i] = -1;
+        n = 0;
+    }
+
+    bool empty() const { return n == 0; }
+    bool contains(int v) const { return pos[v] >= 0; }
+    double key(int v) const { return keys[v]; }
+
+    void push(int v, double k) {
+        keys[v] = k;
+        heap[n] = v;
+        pos[v] = n;
+        up(n++);
+    }
+
+    void decrease(int v, double k) {
+        keys[v] = k;
+        up(pos[v]);
+    }
+
+    int pop() {
+        int top = heap[0];
+        pos[top] = -1;
+        if (--n > 0) {
+            heap[0] = heap[n];
+            pos[heap[0]] = 0;
+            down(0);
+        }
+        return top;
+    }
+
+private:
+    void up(int i) {
+        int v = heap[i];
+        double k = keys[v];
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (!(k < keys[heap[p]])) break;
+            heap[i] = heap[p];
+            pos[heap[i]] = i;
+            i = p;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+
+    void down(int i) {
+        int v = heap[i];
+        double k = keys[v];
+        for (;;) {
+            int first = D * i + 1;
+            if (first >= n) break;
+            int last = first + D < n ? first + D : n;
+            int best = first;
+            for (int c = first + 1; c < last; c++)
+                if (keys[heap[c]] < keys[heap[best]]) best = c;
+            if (!(keys[heap[best]] < k)) break;
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+};
+
+class pairingipq {
+public:
+    // Leftmost child, right sibling, and left sibling or (for a leftmost
+    // child) parent; -1 for none.
+    std::vector<int> child;
+    std::vector<int> next;
+    std::vector<int> prev;
+    std::vector<double> keys;
+    std::vector<char> queued;
+    std::vector<int> pairs;   // pop's scratch list of subtrees
+    int root;
+
+    pairingipq() : root(-1) {}
+
+    void reset(int ids) {
+        if ((int)queued.size() < ids) {
+            child.resize(ids);
+            next.resize(ids);
+            prev.resize(ids);
+            keys.resize(ids);
+            queued.resize(ids);
+        }
+        for (int i = 0; i < ids; i++) queued[i] = 0;
+        root = -1;
+    }
+
+    bool empty() const { return root < 0; }
+    bool contains(int v) const { return queued[v] != 0; }
+    double key(int v) const { return keys[v]; }
+
+    void push(int v, double k) {
+        keys[v] = k;
+        child[v] = next[v] = prev[v] = -1;
+        queued[v] = 1;
+        root = root < 0 ? v : meld(root, v);
+    }
+
+    // Cuts v's subtree out and melds it back with the root.
+    void decrease(int v, double k) {
+        keys[v] = k;
+        if (v == root) return;
+        int p = prev[v];
+        if (child[p] == v)
+            child[p] = next[v];
+        else
+            next[p] = next[v];
+        if (next[v] >= 0) prev[next[v]] = p;
+        next[v] = prev[v] = -1;
+        root = meld(root, v);
+    }
+
+    // Two-pass pairing: meld the children left to right in pairs, then
+    // fold the pairs right to left.
+    int pop() {
+        int top = root;
+        queued[top] = 0;
+        pairs.clear();
+        int c = child[top];
+        while (c >= 0) {
+            int a = c;
+            int b = next[a];
+            c = b >= 0 ? next[b] : -1;
+            next[a] = prev[a] = -1;
+            if (b >= 0) {
+                next[b] = prev[b] = -1;
+                a = meld(a, b);
+            }
+            pairs.push_back(a);
+        }
+        root = -1;
+        for (int i = (int)pairs.size() - 1; i >= 0; i--)
+            root = root < 0 ? pairs[i] : meld(pairs[i], root);
+        return top;
+    }
+
+private:
+    // Both a and b are detached roots; the larger becomes the leftmost
+    // child of the smaller.
+    int meld(int a, int b) {
+        if (keys[b] < keys[a]) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        next[b] = child[a];
+        if (child[a] >= 0) prev[child[a]] = b;
+        prev[b] = a;
+        child[a] = b;
+        return a;
+    }
+};
+
+class radixipq {
+public:
+    static const int BUCKETS = 65;
+
+    std::vector<uint64_t> bits;   // key as ordered bits
+    std::vector<int> next;
+    std::vector<int> prev;
+    std::vector<int> bucket;      // -1 when not queued
+    int head[BUCKETS];
+    uint64_t last;
+    int n;
+
+    radixipq() : last(0), n(0) {
+        for (int b = 0; b < BUCKETS; b++) head[b] = -1;
+    }
+
+    void reset(int ids) {
+        if ((int)bucket.size() < ids) {
+            bits.resize(ids);
+            next.resize(ids);
+            prev.resize(ids);
+            bucket.resize(ids);
+        }
+        for (int i = 0; i < ids; i++) bucket[i] = -1;
+        for (int b = 0; b < BUCKETS; b++) head[b] = -1;
+        last = 0;
+        n = 0;
+    }
+
+    bool empty() const { return n == 0; }
+    bool contains(int v) const { return bucket[v] >= 0; }
+    double key(int v) const {
+        double k;
+        memcpy(&k, &bits[v], sizeof k);
+        return k;
+    }
+
+    void push(int v, double k) {
+        bits[v] = order(k);
+        link(v);
+        n++;
+    }
+
+    void decrease(int v, double k) {
+        unlink(v);
+        bits[v] = order(k);
+        link(v);
+    }
+
+    // Bucket 0 holds keys equal to last. When it runs dry, the lowest
+    // non-empty bucket's minimum becomes last and that bucket is spread
+    // over strictly lower buckets.
+    int pop() {
+        if (head[0] < 0) {
+            int b = 1;
+            while (head[b] < 0) b++;
+            uint64_t m = bits[head[b]];
+            for (int v = head[b]; v >= 0; v = next[v])
+                if (bits[v] < m) m = bits[v];
+            last = m;
+            int v = head[b];
+            head[b] = -1;
+            while (v >= 0) {
+                int after = next[v];
+                link(v);
+                v = after;
+            }
+        }
+        int top = head[0];
+        unlink(top);
+        bucket[top] = -1;
+        n--;
+        return top;
+    }
+
+private:
+    // Non-negative doubles order the same as their bit patterns.
+    static uint64_t order(double k) {
+        uint64_t b;
+        memcpy(&b, &k, sizeof b);
+        return b;
+    }
+
+    int bucketof(uint64_t b) const {
+        uint64_t x = b ^ last;
+        int h = 0;
+        while (x) {
+            h++;
+            x >>= 1;
+        }
+        return h;
+    }
+
+    void link(int v) {
+        int b = bucketof(bits[v]);
+        bucket[v] = b;
+        prev[v] = -1;
+        next[v] = head[b];
+        if (head[b] >= 0) prev[head[b]] = v;
+        head[b] = v;
+    }
+
+    void unlink(int v) {
+        int b = bucket[v];
+        if (prev[v] >= 0)
+            next[prev[v]] = next[v];
+        else
+            head[b] = next[v];
+        if (next[v] >= 0) prev[next[v]] = prev[v];
+    }
+};
+
+// Queue used by graph::dijkstra and graph::prim, chosen at build time with
+// -DDS_GRAPH_PQ=<n>. prim's keys are edge weights and not monotone, so it
+// uses the d-ary heap when the radix heap is selected.
+#define DS_PQ_DARY 0
+#define DS_PQ_PAIRING 1
+#define DS_PQ_RADIX 2
+#ifndef DS_GRAPH_PQ
+#define DS_GRAPH_PQ DS_PQ_DARY
+#endif
+
+#if DS_GRAPH_PQ == DS_PQ_PAIRING
+typedef pairingipq dijkstrapq;
+typedef pairingipq primpq;
+#elif DS_GRAPH_PQ == DS_PQ_RADIX
+typedef radixipq dijkstrapq;
+typedef daryipq<4> primpq;
+#else
+typedef daryipq<4> dijkstrapq;
+typedef daryipq<4> primpq;
+#endif
@@ -0,0 +1,146 @@
+#include "multiqueue.h"
+#include "threadpool.h"
+
+// Runs longer than this are split so one batch cannot fill a single shard.
+static const int BATCHRUN = 64;
+
+multiqueue::multiqueue(int nshards, int mode, bool strict) {
+    if (nshards <= 0) nshards = 2 * threadpool::shared().size();
+    if (nshards < 1) nshards = 1;
+    this->nshards = nshards;
+    this->mode = mode;
+    this->strict = strict;
+    shards = new shard[nshards];
+    for (int i = 0; i < nshards; i++) {
+        shards[i].h.setMode(mode);
+        shards[i].top.store(0, std::memory_order_relaxed);
+        shards[i].count.store(0, std::memory_order_relaxed);
+    }
+}
+
+multiqueue::~multiqueue() {
+    delete[] shards;
+}
+
+// Per-thread xorshift; the seed mixes in the state's own address so
+// threads start apart.
+int multiqueue::pick() {
+    static thread_local unsigned int state = 0;
+    if (state == 0) state = (unsigned int)(size_t)&state | 1;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (int)(state % (unsigned int)nshards);
+}
+
+void multiqueue::publish(shard& s) {
+    int n = s.h.getSize();
+    if (n > 0) s.top.store(s.h.getElement(1), std::memory_order_relaxed);
+    s.count.store(n, std::memory_order_release);
+}
+
+// Locks some shard, preferring an uncontended one: a few try_locks on
+// random shards before blocking on the last one tried.
+void multiqueue::insert(shard& first, const int* values, int n) {
+    shard* s = &first;
+    for (int tries = 0; !s->lock.try_lock(); tries++) {
+        if (tries == 4) {
+            s->lock.lock();
+            break;
+        }
+        s = &shards[pick()];
+    }
+    s->h.insertBatch(values, n);
+    publish(*s);
+    s->lock.unlock();
+}
+
+void multiqueue::push(int value) {
+    insert(shards[pick()], &value, 1);
+}
+
+void multiqueue::pushBatch(const int* values, int n) {
+    for (int i = 0; i < n; i += BATCHRUN) {
+        int run = n - i < BATCHRUN ? n - i : BATCHRUN;
+        insert(shards[pick()], values + i, run);
+    }
+}
+
+// Shard whose published root comes first, with that root in topval;
+// -1 when every shard looks empty.
+int multiqueue::bestshard(int& topval) const {
+    int best = -1;
+    for (int i = 0; i < nshards; i++) {
+        if (shards[i].count.load(std::memory_order_acquire) == 0) continue;
+        int t = shards[i].top.load(std::memory_order_relaxed);
+        if (best < 0 || before(t, topval)) {
+            best = i;
+            topval = t;
+        }
+    }
+    return best;
+}
+
+// Picks the best shard from the published roots and locks only that one.
+// Under the lock its real root is compared against the published roots
+// again; if another shard has a better one by now, the pop starts over.
+bool multiqueue::popstrict(int& out) {
+    for (;;) {
+        int t;
+        int i = bestshard(t);
+        if (i < 0) return false;
+        shard& s = shards[i];
+        std::lock_guard<std::mutex> g(s.lock);
+        if (s.h.getSize() == 0) continue;
+        int root = s.h.getElement(1);
+        int j = bestshard(t);
+        if (j != i && before(t, root)) continue;
+        s.h.extractK(1, &out);
+        publish(s);
+        return true;
+    }
+}
+
+bool multiqueue::pop(int& out) {
+    if (strict || nshards == 1) return popstrict(out);
+
+    for (int attempt = 0; attempt < 2 * nshards; attempt++) {
+        int a = pick();
+        int b = pick();
+        int na = shards[a].count.load(std::memory_order_acquire);
+        int nb = shards[b].count.load(std::memory_order_acquire);
+        if (na == 0 && nb == 0) continue;
+        int i = a;
+        if (na == 0 || (nb > 0 && before(shards[b].top.load(std::memory_order_relaxed),
+                                          shards[a].top.load(std::memory_order_relaxed))))
+            i = b;
+        shard& s = shards[i];
+        if (!s.lock.try_lock()) continue;
+        // The cached root may be stale; whatever is there now is fine.
+        bool got = s.h.getSize() > 0;
+        if (got) {
+            s.h.extractK(1, &out);
+            publish(s);
+        }
+        s.lock.unlock();
+        if (got) return true;
+    }
+
+    // Sampling kept missing: sweep every shard before reporting empty.
+    for (int i = 0; i < nshards; i++) {
+        shard& s = shards[i];
+        if (s.count.load(std::memory_order_acquire) == 0) continue;
+        std::lock_guard<std::mutex> g(s.lock);
+        if (s.h.getSize() == 0) continue;
+        s.h.extractK(1, &out);
+        publish(s);
+        return true;
+    }
+    return false;
+}
+
+int multiqueue::size() const {
+    int n = 0;
+    for (int i = 0; i < nshards; i++) n += shards[i].count.load(std::memory_order_relaxed);
+    return n;
+}
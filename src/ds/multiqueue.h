@@ -0,0 +1,54 @@
+#pragma once
+#include "heap.h"
+#include <atomic>
+#include <mutex>
+
+// Concurrent priority queue over several independently locked heaps
+// (MultiQueue, Rihani et al.). Any number of threads may push and pop.
+//
+// Relaxed mode: push goes to a random shard; pop samples two shards,
+// compares their cached roots without locking and pops the better one.
+// A pop returns one of the best few values rather than the single best,
+// and threads rarely touch the same lock.
+//
+// Strict mode: push is the same, and pop reads the published roots,
+// locks only the shard with the best one and re-checks it under that
+// lock, retrying if another shard has overtaken it. A pop then returns a
+// value no worse than any value whose push finished before the pop began
+// and that no other pop took, so values come out in exact priority
+// order, for one lock per pop.
+class multiqueue {
+public:
+    struct alignas(64) shard {
+        std::mutex lock;
+        heap h;
+        // Root and size published after each change, read unlocked by pop.
+        std::atomic<int> top;
+        std::atomic<int> count;
+    };
+
+    shard* shards;
+    int nshards;
+    int mode;    // heapmode
+    bool strict;
+
+    // nshards <= 0 picks two per thread of threadpool::shared().
+    multiqueue(int nshards = 0, int mode = HEAP_MIN, bool strict = false);
+    ~multiqueue();
+
+    void push(int value);
+    // Spreads values over the shards a run at a time.
+    void pushBatch(const int* values, int n);
+    // False when every shard was empty.
+    bool pop(int& out);
+    // Exact when no push or pop is in flight.
+    int size() const;
+
+private:
+    bool before(int a, int b) const { return mode == HEAP_MIN ? a < b : a > b; }
+    int pick();
+    void publish(shard& s);
+    void insert(shard& s, const int* values, int n);
+    int bestshard(int& topval) const;
+    bool popstrict(int& out);
+};
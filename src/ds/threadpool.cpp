@@ -0,0 +1,109 @@
+#include "threadpool.h"
+
+static thread_local bool insidejob = false;
+
+threadpool::threadpool(int threads) {
+#if DS_THREADS
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+#else
+    threads = 1;
+#endif
+    nthreads = threads;
+    stopping = false;
+    generation = 0;
+    active = 0;
+    job = nullptr;
+    jobsize = 0;
+    jobgrain = 1;
+    next = 0;
+
+    // The calling thread acts as worker 0.
+    for (int t = 1; t < nthreads; t++)
+        workers.emplace_back(&threadpool::workerloop, this, t);
+}
+
+threadpool::~threadpool() {
+    {
+        std::lock_guard<std::mutex> lk(m);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+int threadpool::size() const {
+    return nthreads;
+}
+
+threadpool& threadpool::shared() {
+    static threadpool pool;
+    return pool;
+}
+
+void threadpool::runchunks(int tid) {
+    bool outer = insidejob;
+    insidejob = true;
+    while (true) {
+        int begin = next.fetch_add(jobgrain);
+        if (begin >= jobsize) break;
+        int end = begin + jobgrain;
+        if (end > jobsize) end = jobsize;
+        (*job)(begin, end, tid);
+    }
+    insidejob = outer;
+}
+
+void threadpool::workerloop(int tid) {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(m);
+            wake.wait(lk, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        runchunks(tid);
+        {
+            std::lock_guard<std::mutex> lk(m);
+            active--;
+        }
+        done.notify_one();
+    }
+}
+
+void threadpool::parallelfor(int n, int grain, const rangefn& fn) {
+    if (n <= 0) return;
+    if (grain < 1) grain = 1;
+
+    if (nthreads == 1 || insidejob || n <= grain) {
+        bool outer = insidejob;
+        insidejob = true;
+        fn(0, n, 0);
+        insidejob = outer;
+        return;
+    }
+
+    std::lock_guard<std::mutex> serial(runlock);
+
+    // Aim for a few chunks per thread so uneven chunks balance out.
+    int chunk = n / (nthreads * 4);
+    if (chunk < grain) chunk = grain;
+
+    {
+        std::lock_guard<std::mutex> lk(m);
+        job = &fn;
+        jobsize = n;
+        jobgrain = chunk;
+        next = 0;
+        active = nthreads - 1;
+        generation++;
+    }
+    wake.notify_all();
+
+    runchunks(0);
+
+    std::unique_lock<std::mutex> lk(m);
+    done.wait(lk, [&] { return active == 0; });
+    job = nullptr;
+}
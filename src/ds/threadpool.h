@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WASM builds without pthreads get a pool of size 1 that runs every job
+// inline on the calling thread.
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define DS_THREADS 0
+#else
+#define DS_THREADS 1
+#endif
+
+class threadpool {
+public:
+    // fn(begin, end, tid) is called on disjoint chunks of [0, n).
+    // tid is in [0, size()) and is stable for the whole job, so callers
+    // can index per-thread buffers with it.
+    typedef std::function<void(int, int, int)> rangefn;
+
+    threadpool(int threads = 0);
+    ~threadpool();
+
+    int size() const;
+
+    // Splits [0, n) into chunks of at least grain items and blocks until
+    // all of them ran. Calls made from inside a job run serially.
+    void parallelfor(int n, int grain, const rangefn& fn);
+
+    // Process-wide pool sized to the hardware.
+    static threadpool& shared();
+
+private:
+    int nthreads;
+    std::vector<std::thread> workers;
+
+    std::mutex runlock;
+    std::mutex m;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping;
+    unsigned long generation;
+    int active;
+
+    const rangefn* job;
+    int jobsize;
+    int jobgrain;
+    std::atomic<int> next;
+
+    void workerloop(int tid);
+    void runchunks(int tid);
+};
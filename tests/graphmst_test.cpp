@@ -0,0 +1,48 @@
+// g++ -std=c++17 -pthread tests/graphmst_test.cpp src/ds/*.cpp -o graphmst_test
+#include "../src/ds/graph.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static double total(int (graph::*mst)(int*, double*), graph& g, int& count) {
+    std::vector<int> edges(2 * g.getVertexCount() + 2);
+    std::vector<double> weights(g.getVertexCount() + 1);
+    count = (g.*mst)(edges.data(), weights.data());
+    double sum = 0;
+    for (int i = 0; i < count; i++) sum += weights[i];
+    return sum;
+}
+
+static void check(graph& g) {
+    int kc, bc;
+    double k = total(&graph::kruskal, g, kc);
+    double b = total(&graph::boruvka, g, bc);
+    assert(kc == bc);
+    assert(fabs(k - b) < 1e-9);
+}
+
+int main() {
+    // Directed edges whose lighter side only shows up as an in-edge.
+    graph g(3);
+    g.addedge(0, 1, 5);
+    g.addedge(2, 0, 1);
+    g.addedge(1, 2, 10);
+    int n;
+    assert(total(&graph::boruvka, g, n) == 6 && n == 2);
+    check(g);
+
+    srand(1);
+    for (int it = 0; it < 50; it++) {
+        int V = 1 + rand() % 200;
+        graph r(V);
+        int E = rand() % (3 * V + 1);
+        for (int i = 0; i < E; i++) r.addedge(rand() % V, rand() % V, rand() % 50);
+        check(r);
+        r.freeze();
+        check(r);
+    }
+    printf("graphmst_test ok\n");
+    return 0;
+}
@@ -0,0 +1,39 @@
+// g++ -std=c++17 -pthread tests/graphsssp_test.cpp src/ds/*.cpp -o graphsssp_test
+#include "../src/ds/graph.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static void check(graph& g, int s, double delta) {
+    int V = g.getVertexCount();
+    std::vector<double> want(V), got(V);
+    std::vector<int> p(V), q(V);
+    g.dijkstra(s, want.data(), p.data());
+    g.deltastepping(s, delta, got.data(), q.data());
+    for (int v = 0; v < V; v++) assert(want[v] == got[v] || fabs(want[v] - got[v]) < 1e-9);
+}
+
+int main() {
+    // A delta far below max weight / bucket cap must not size the ring
+    // off the raw ratio.
+    graph g(3);
+    g.addedge(0, 1, 1e6);
+    g.addedge(1, 2, 0.5);
+    check(g, 0, 1e-3);
+    check(g, 0, 1e-300);
+    check(g, 0, nan(""));
+
+    srand(2);
+    for (int it = 0; it < 30; it++) {
+        int V = 1 + rand() % 300;
+        graph r(V);
+        int E = rand() % (4 * V + 1);
+        for (int i = 0; i < E; i++) r.addedge(rand() % V, rand() % V, (rand() % 100000) / 7.0);
+        double deltas[] = {0, 1e-6, 0.5, 100, 1e9};
+        for (int d = 0; d < 5; d++) check(r, rand() % V, deltas[d]);
+    }
+    printf("graphsssp_test ok\n");
+    return 0;
+}
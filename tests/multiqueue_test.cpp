@@ -0,0 +1,125 @@
+// g++ -std=c++17 -pthread tests/multiqueue_test.cpp src/ds/multiqueue.cpp src/ds/heap.cpp src/ds/threadpool.cpp -o multiqueue_test
+#include "../src/ds/multiqueue.h"
+#include <assert.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const int PRODUCERS = 8;
+static const int CONSUMERS = 8;
+static const int PER = 20000;
+
+// Producers and consumers run at the same time; every value must come out
+// exactly once.
+static void mixed(bool strict) {
+    multiqueue q(2 * PRODUCERS, HEAP_MIN, strict);
+    std::atomic<int> producing(PRODUCERS);
+    std::vector<std::vector<int> > got(CONSUMERS);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; p++)
+        threads.push_back(std::thread([&, p] {
+            std::vector<int> batch;
+            for (int i = 0; i < PER; i++) {
+                int v = p * PER + i;
+                if (i % 4) q.push(v);
+                else batch.push_back(v);
+                if (batch.size() == 32) {
+                    q.pushBatch(batch.data(), (int)batch.size());
+                    batch.clear();
+                }
+            }
+            q.pushBatch(batch.data(), (int)batch.size());
+            producing--;
+        }));
+    for (int c = 0; c < CONSUMERS; c++)
+        threads.push_back(std::thread([&, c] {
+            int v;
+            for (;;) {
+                // Read before popping: an empty pop after every producer
+                // finished means the queue is drained for good.
+                bool done = producing.load() == 0;
+                if (q.pop(v)) got[c].push_back(v);
+                else if (done) break;
+            }
+        }));
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+    std::vector<char> seen(PRODUCERS * PER, 0);
+    int total = 0;
+    for (int c = 0; c < CONSUMERS; c++)
+        for (size_t i = 0; i < got[c].size(); i++) {
+            int v = got[c][i];
+            assert(v >= 0 && v < PRODUCERS * PER && !seen[v]);
+            seen[v] = 1;
+            total++;
+        }
+    assert(total == PRODUCERS * PER);
+    assert(q.size() == 0);
+}
+
+// With only pops in flight, strict mode is linearizable: each consumer
+// sees its own values in ascending order.
+static void strictorder() {
+    multiqueue q(8, HEAP_MIN, true);
+    for (int i = PRODUCERS * PER - 1; i >= 0; i--) q.push(i);
+    std::vector<std::thread> threads;
+    std::atomic<int> total(0);
+    for (int c = 0; c < CONSUMERS; c++)
+        threads.push_back(std::thread([&] {
+            int v, last = -1, n = 0;
+            while (q.pop(v)) {
+                assert(v > last);
+                last = v;
+                n++;
+            }
+            total += n;
+        }));
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    assert(total.load() == PRODUCERS * PER);
+}
+
+// Pushers run alongside the pops, always with values above everything
+// preloaded. A pop never returns a late value while an older, smaller
+// one is still queued, so once a consumer sees a late value it never
+// sees a preloaded one again.
+static void strictmixed() {
+    const int BASE = PRODUCERS * PER;
+    multiqueue q(8, HEAP_MIN, true);
+    for (int i = 0; i < BASE; i++) q.push(i);
+    std::atomic<int> producing(PRODUCERS);
+    std::vector<std::thread> threads;
+    std::atomic<int> total(0);
+    for (int p = 0; p < PRODUCERS; p++)
+        threads.push_back(std::thread([&, p] {
+            for (int i = 0; i < PER; i++) q.push(BASE + p * PER + i);
+            producing--;
+        }));
+    for (int c = 0; c < CONSUMERS; c++)
+        threads.push_back(std::thread([&] {
+            int v, n = 0;
+            bool late = false;
+            for (;;) {
+                bool done = producing.load() == 0;
+                if (!q.pop(v)) {
+                    if (done) break;
+                    continue;
+                }
+                if (v >= BASE) late = true;
+                else assert(!late);
+                n++;
+            }
+            total += n;
+        }));
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    assert(total.load() == 2 * BASE);
+}
+
+int main() {
+    mixed(false);
+    mixed(true);
+    strictorder();
+    strictmixed();
+    printf("multiqueue_test ok\n");
+    return 0;
+}